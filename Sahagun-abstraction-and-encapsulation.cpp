@@ -1,21 +1,117 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
 #include <iostream>
-#include <regex>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Optional snapshot encryption (AES-256-GCM, AES-NI accelerated by OpenSSL where the CPU has it).
+// Build with -DPAYROLL_WITH_OPENSSL and link with -lcrypto to enable.
+#ifdef PAYROLL_WITH_OPENSSL
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#endif
+
+#include "payroll.h"
+
+// write(2), used to dump the flight recorder from a signal handler
+#ifdef _WIN32
+#include <io.h>
+#define STDERR_FILENO 2
+#else
+#include <unistd.h>
+#endif
+
+// popen/pclose, used by the subprocess benchmark
+#if defined(_WIN32) && !defined(PAYROLL_LIBRARY)
+#define popen _popen
+#define pclose _pclose
+#endif
+
 using namespace std;
 
+// Longest input line accepted from the console; longer lines are discarded
+const size_t MAX_INPUT_LINE = 1024;
+
+// Thrown when the console input ends (e.g. end of a piped file) so the program can exit cleanly
+class InputClosedError : public runtime_error {
+    public:
+        InputClosedError() : runtime_error("input closed") {}
+};
+
+// Reads one line of console input, never buffering more than MAX_INPUT_LINE characters.
+// Overlong lines are discarded and returned as an empty line.
+string readConsoleLine() {
+    string line;
+    bool tooLong = false;
+    int c;
+    while ((c = cin.get()) != EOF && c != '\n') {
+        if (line.size() < MAX_INPUT_LINE) {
+            line += static_cast<char>(c);
+        } else {
+            tooLong = true;
+        }
+    }
+    if (c == EOF && line.empty() && !tooLong) {
+        throw InputClosedError();
+    }
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back(); // Tolerate Windows line endings in piped input
+    }
+    if (tooLong) {
+        cout << "Input too long (maximum " << MAX_INPUT_LINE << " characters)." << endl;
+        line.clear();
+    }
+    return line;
+}
+
 // Validates if the input is an integer and converts it to an integer if valid.
-bool isValidInteger(const string& input, int& output) {
-    try {
-        size_t pos;
-        output = stoi(input, &pos);
-        if (pos == input.length()) { // Ensures entire string is converted
-            return true;
+// Like stoi, leading whitespace and a '+' sign are accepted; nothing may follow the digits.
+bool isValidInteger(string_view input, int& output) {
+    size_t first = 0;
+    while (first < input.size() && isspace(static_cast<unsigned char>(input[first]))) {
+        ++first;
+    }
+    if (first < input.size() && input[first] == '+') {
+        ++first;
+        if (first < input.size() && input[first] == '-') {
+            return false;
         }
-    } catch (const exception&) {
-        return false; // If conversion fails, return false
     }
-    return false;
+    const char* end = input.data() + input.size();
+    from_chars_result parsed = from_chars(input.data() + first, end, output);
+    return parsed.ec == errc() && parsed.ptr == end; // Ensures entire string is converted and fits
 }
 
 // Validates if the input is within a specified menu number range.
@@ -27,26 +123,351 @@ bool isValidMenuNumber(const string& input, int& output, int min, int max) {
     return false;
 }
 
-// Validates if the input is a valid decimal number format (for salary and hours)
-bool isValidDecimal(const string& input, double& output) {
-    regex decimalRegex("^\\d+(\\.\\d{1,2})?$"); // Regular expression for decimal numbers
-    if (regex_match(input, decimalRegex)) {
-        output = stod(input);
-        return true;
+// Validates if the input is a valid decimal number format (for salary and hours):
+// one or more digits, optionally followed by a point and one or two digits.
+// Single left-to-right scan, so the cost is linear in the input length.
+bool isValidDecimal(string_view input, double& output) {
+    size_t i = 0;
+    while (i < input.size() && input[i] >= '0' && input[i] <= '9') {
+        ++i;
     }
-    return false;
+    if (i == 0) {
+        return false;
+    }
+    if (i < input.size()) {
+        size_t fractionDigits = input.size() - i - 1;
+        if (input[i] != '.' || fractionDigits < 1 || fractionDigits > 2) {
+            return false;
+        }
+        for (size_t j = i + 1; j < input.size(); ++j) {
+            if (input[j] < '0' || input[j] > '9') {
+                return false;
+            }
+        }
+    }
+    from_chars_result parsed = from_chars(input.data(), input.data() + input.size(), output);
+    return parsed.ec == errc() && isfinite(output); // Out of range if too large to represent
 }
 
 // Validates if the ID is valid (no whitespace, alphanumeric only)
-bool isValidID(const string& id) {
-    // Check for whitespace
-    if (id.find(' ') != string::npos) {
+bool isValidID(string_view id) {
+    if (id.empty()) {
         return false;
     }
     
-    // Check if ID contains only alphanumeric characters
-    regex idRegex("^[a-zA-Z0-9]+$");
-    return regex_match(id, idRegex);
+    // Check if ID contains only alphanumeric characters (which also rules out whitespace)
+    for (char c : id) {
+        bool alphanumeric = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        if (!alphanumeric) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Computes a 64-bit FNV-1a hash of the data (used to address unencrypted snapshot chunks)
+uint64_t fnv1aHash(const string& data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Formats a 64-bit value as a fixed-width hexadecimal string
+string toHex(uint64_t value) {
+    const char* digits = "0123456789abcdef";
+    string hex(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        hex[i] = digits[value & 0xF];
+        value >>= 4;
+    }
+    return hex;
+}
+
+// Formats raw bytes as a lowercase hexadecimal string
+string bytesToHex(const string& bytes) {
+    const char* digits = "0123456789abcdef";
+    string hex;
+    hex.reserve(bytes.size() * 2);
+    for (unsigned char c : bytes) {
+        hex += digits[c >> 4];
+        hex += digits[c & 0xF];
+    }
+    return hex;
+}
+
+// Computes the SHA-256 digest of the data (32 raw bytes); used for the tamper-evident audit log
+string sha256(const string& data) {
+    static const uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    auto rotr = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+    
+    // Pad: 0x80, zeros, then the bit length as a 64-bit big-endian number
+    string message = data;
+    message += static_cast<char>(0x80);
+    while (message.size() % 64 != 56) {
+        message += '\0';
+    }
+    uint64_t bitLength = static_cast<uint64_t>(data.size()) * 8;
+    for (int i = 7; i >= 0; --i) {
+        message += static_cast<char>((bitLength >> (i * 8)) & 0xFF);
+    }
+    
+    for (size_t block = 0; block < message.size(); block += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(message.data()) + block + i * 4;
+            w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t t1 = hh + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            hh = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+    }
+    
+    string digest(32, '\0');
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            digest[i * 4 + j] = static_cast<char>((h[i] >> (24 - j * 8)) & 0xFF);
+        }
+    }
+    return digest;
+}
+
+// Computes HMAC-SHA-256 of the data under the key (32 raw bytes); names encrypted snapshot chunks
+// so that a chunk's name reveals nothing about its records to someone without the key
+string hmacSha256(const string& key, const string& data) {
+    string block = key.size() > 64 ? sha256(key) : key;
+    block.resize(64, '\0');
+    string inner(64, '\0'), outer(64, '\0');
+    for (size_t i = 0; i < 64; ++i) {
+        inner[i] = static_cast<char>(block[i] ^ 0x36);
+        outer[i] = static_cast<char>(block[i] ^ 0x5c);
+    }
+    return sha256(outer + sha256(inner + data));
+}
+
+// Computes the Merkle root of a list of leaf hashes (an odd node is promoted to the next level)
+string merkleRoot(vector<string> level) {
+    if (level.empty()) {
+        return sha256("");
+    }
+    while (level.size() > 1) {
+        vector<string> next;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            next.push_back(i + 1 < level.size() ? sha256(level[i] + level[i + 1]) : level[i]);
+        }
+        level.swap(next);
+    }
+    return level[0];
+}
+
+// Decodes a hexadecimal string into raw bytes; returns false if it is not valid hex
+bool parseHex(const string& hex, string& bytes) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    bytes.clear();
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        int value = 0;
+        for (size_t j = i; j < i + 2; ++j) {
+            char c = static_cast<char>(tolower(static_cast<unsigned char>(hex[j])));
+            if (c >= '0' && c <= '9') {
+                value = value * 16 + (c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value = value * 16 + (c - 'a' + 10);
+            } else {
+                return false;
+            }
+        }
+        bytes += static_cast<char>(value);
+    }
+    return true;
+}
+
+// Header marking an encrypted snapshot chunk: magic, 8-byte key ID, then 12-byte nonce, ciphertext
+// and 16-byte tag
+const string ENCRYPTED_CHUNK_MAGIC = "PAYENC1\n";
+const size_t CHUNK_KEY_ID_SIZE = 8;
+const size_t CHUNK_NONCE_SIZE = 12;
+const size_t CHUNK_TAG_SIZE = 16;
+
+// Identifies a snapshot key without revealing it, so chunks written under another key are recognized
+string snapshotKeyId(const string& key) {
+    return hmacSha256(key, "payroll snapshot key id").substr(0, CHUNK_KEY_ID_SIZE);
+}
+
+// Returns true if the stored chunk data starts with an encrypted chunk header
+bool isEncryptedChunk(const string& stored) {
+    return stored.compare(0, ENCRYPTED_CHUNK_MAGIC.size(), ENCRYPTED_CHUNK_MAGIC) == 0;
+}
+
+// Returns true if this build can encrypt snapshot chunks
+bool snapshotEncryptionAvailable() {
+#ifdef PAYROLL_WITH_OPENSSL
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Encrypts and authenticates a snapshot chunk with AES-256-GCM. The associated data (the chunk's
+// hash) is authenticated too, so a chunk cannot be swapped in under another chunk's name.
+bool encryptChunk(const string& key, const string& associatedData, const string& plain, string& stored) {
+#ifdef PAYROLL_WITH_OPENSSL
+    unsigned char nonce[CHUNK_NONCE_SIZE];
+    unsigned char tag[CHUNK_TAG_SIZE];
+    if (RAND_bytes(nonce, sizeof(nonce)) != 1) {
+        return false;
+    }
+    string cipher(plain.size(), '\0');
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int length = 0;
+    bool ok = ctx != nullptr &&
+        EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, nullptr, nullptr) == 1 &&
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, CHUNK_NONCE_SIZE, nullptr) == 1 &&
+        EVP_EncryptInit_ex(ctx, nullptr, nullptr, reinterpret_cast<const unsigned char*>(key.data()), nonce) == 1 &&
+        EVP_EncryptUpdate(ctx, nullptr, &length, reinterpret_cast<const unsigned char*>(associatedData.data()),
+                          static_cast<int>(associatedData.size())) == 1 &&
+        EVP_EncryptUpdate(ctx, reinterpret_cast<unsigned char*>(&cipher[0]), &length,
+                          reinterpret_cast<const unsigned char*>(plain.data()), static_cast<int>(plain.size())) == 1 &&
+        EVP_EncryptFinal_ex(ctx, reinterpret_cast<unsigned char*>(&cipher[0]) + length, &length) == 1 &&
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, CHUNK_TAG_SIZE, tag) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    if (!ok) {
+        return false;
+    }
+    stored = ENCRYPTED_CHUNK_MAGIC + snapshotKeyId(key);
+    stored.append(reinterpret_cast<char*>(nonce), sizeof(nonce));
+    stored += cipher;
+    stored.append(reinterpret_cast<char*>(tag), sizeof(tag));
+    return true;
+#else
+    (void)key; (void)associatedData; (void)plain; (void)stored;
+    return false;
+#endif
+}
+
+// Decrypts a stored snapshot chunk, verifying its authentication tag
+bool decryptChunk(const string& key, const string& associatedData, const string& stored, string& plain) {
+#ifdef PAYROLL_WITH_OPENSSL
+    size_t keyIdEnd = ENCRYPTED_CHUNK_MAGIC.size() + CHUNK_KEY_ID_SIZE;
+    size_t header = keyIdEnd + CHUNK_NONCE_SIZE;
+    if (key.empty() || stored.size() < header + CHUNK_TAG_SIZE ||
+        stored.compare(ENCRYPTED_CHUNK_MAGIC.size(), CHUNK_KEY_ID_SIZE, snapshotKeyId(key)) != 0) {
+        return false;
+    }
+    const unsigned char* nonce = reinterpret_cast<const unsigned char*>(stored.data()) + keyIdEnd;
+    size_t cipherSize = stored.size() - header - CHUNK_TAG_SIZE;
+    string tag = stored.substr(stored.size() - CHUNK_TAG_SIZE);
+    plain.assign(cipherSize, '\0');
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int length = 0;
+    bool ok = ctx != nullptr &&
+        EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, nullptr, nullptr) == 1 &&
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, CHUNK_NONCE_SIZE, nullptr) == 1 &&
+        EVP_DecryptInit_ex(ctx, nullptr, nullptr, reinterpret_cast<const unsigned char*>(key.data()), nonce) == 1 &&
+        EVP_DecryptUpdate(ctx, nullptr, &length, reinterpret_cast<const unsigned char*>(associatedData.data()),
+                          static_cast<int>(associatedData.size())) == 1 &&
+        EVP_DecryptUpdate(ctx, reinterpret_cast<unsigned char*>(&plain[0]), &length,
+                          reinterpret_cast<const unsigned char*>(stored.data()) + header, static_cast<int>(cipherSize)) == 1 &&
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, CHUNK_TAG_SIZE, &tag[0]) == 1 &&
+        EVP_DecryptFinal_ex(ctx, reinterpret_cast<unsigned char*>(&plain[0]) + length, &length) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    return ok;
+#else
+    (void)key; (void)associatedData; (void)stored; (void)plain;
+    return false;
+#endif
+}
+
+// Returns true if an existing chunk file is stored the way it would be written now: encrypted under
+// this key if one is set, otherwise in plain form. Only the header is read.
+bool storedChunkMatches(const filesystem::path& path, const string& key) {
+    ifstream in(path, ios::binary);
+    string header(ENCRYPTED_CHUNK_MAGIC.size() + CHUNK_KEY_ID_SIZE, '\0');
+    in.read(&header[0], static_cast<streamsize>(header.size()));
+    header.resize(static_cast<size_t>(in.gcount()));
+    if (!in.is_open()) {
+        return false;
+    }
+    if (key.empty()) {
+        return !isEncryptedChunk(header);
+    }
+    return header == ENCRYPTED_CHUNK_MAGIC + snapshotKeyId(key);
+}
+
+// Scrambles a 64-bit value (splitmix64 finalizer); used to derive independent hash functions
+uint64_t mixHash(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+// Number of MinHash values per name, split into LSH bands of rows
+const int MINHASH_BANDS = 8;
+const int MINHASH_ROWS = 4;
+const int MINHASH_SIZE = MINHASH_BANDS * MINHASH_ROWS;
+
+// Normalizes a name for comparison: lowercase letters and digits, single spaces between
+// words, and one space at each end
+string normalizeName(const string& name) {
+    string normalized = " ";
+    for (unsigned char c : name) {
+        if (isalnum(c)) {
+            normalized += static_cast<char>(tolower(c));
+        } else if (normalized.back() != ' ') {
+            normalized += ' ';
+        }
+    }
+    if (normalized.back() != ' ') {
+        normalized += ' ';
+    }
+    return normalized;
+}
+
+// Computes the MinHash signature of a name over its lowercase character 3-grams
+vector<uint64_t> nameSignature(const string& name) {
+    string normalized = normalizeName(name);
+    vector<uint64_t> signature(MINHASH_SIZE, numeric_limits<uint64_t>::max());
+    for (size_t i = 0; i + 3 <= normalized.size(); ++i) {
+        uint64_t shingle = fnv1aHash(normalized.substr(i, 3));
+        for (int k = 0; k < MINHASH_SIZE; ++k) {
+            signature[k] = min(signature[k], mixHash(shingle + 0x9e3779b97f4a7c15ULL * (k + 1)));
+        }
+    }
+    return signature;
+}
+
+// Estimates the Jaccard similarity of two names from their MinHash signatures
+double signatureSimilarity(const vector<uint64_t>& a, const vector<uint64_t>& b) {
+    int matches = 0;
+    for (int k = 0; k < MINHASH_SIZE; ++k) {
+        matches += (a[k] == b[k]) ? 1 : 0;
+    }
+    return static_cast<double>(matches) / MINHASH_SIZE;
 }
 
 // Abstract base class for Employee (Abstraction)
@@ -61,17 +482,20 @@ class Employee {
     
     // Pure virtual functions (Abstraction)
         virtual double calculateSalary() const = 0;
-        virtual void displayPayrollReport() const = 0;
+        virtual void displayPayrollReport(ostream& out) const = 0;
+        
+        // Writes the employee as one snapshot record line: type|id|pay fields|name
+        virtual void writeRecord(ostream& out) const = 0;
         
         // Virtual destructor
         virtual ~Employee() {}
         
         // Getter methods (Encapsulation)
-        string getId() const {
+        const string& getId() const {
             return id;
         }
         
-        string getName() const {
+        const string& getName() const {
             return name;
         }
 };
@@ -92,9 +516,18 @@ class FullTimeEmployee : public Employee {
         }
         
         // Override displayPayrollReport method
-        void displayPayrollReport() const override {
-            cout << "Employee: " << getName() << " (ID: " << getId() << ")" << endl;
-            cout << "Fixed Monthly Salary: $" << salary << endl;
+        void displayPayrollReport(ostream& out) const override {
+            out << "Employee: " << getName() << " (ID: " << getId() << ")" << endl;
+            out << "Fixed Monthly Salary: $" << salary << endl;
+        }
+        
+        double getSalary() const {
+            return salary;
+        }
+        
+        // Override writeRecord method
+        void writeRecord(ostream& out) const override {
+            out << "F|" << getId() << "|" << salary << "|" << getName() << "\n";
         }
 };
 
@@ -115,11 +548,24 @@ class PartTimeEmployee : public Employee {
         }
         
         // Override displayPayrollReport method
-        void displayPayrollReport() const override {
-            cout << "Employee: " << getName() << " (ID: " << getId() << ")" << endl;
-            cout << "Hourly Wage: $" << hourlyWage << endl;
-            cout << "Hours Worked: " << hoursWorked << endl;
-            cout << "Total Salary: $" << calculateSalary() << endl;
+        void displayPayrollReport(ostream& out) const override {
+            out << "Employee: " << getName() << " (ID: " << getId() << ")" << endl;
+            out << "Hourly Wage: $" << hourlyWage << endl;
+            out << "Hours Worked: " << hoursWorked << endl;
+            out << "Total Salary: $" << calculateSalary() << endl;
+        }
+        
+        double getHourlyWage() const {
+            return hourlyWage;
+        }
+        
+        double getHoursWorked() const {
+            return hoursWorked;
+        }
+        
+        // Override writeRecord method
+        void writeRecord(ostream& out) const override {
+            out << "P|" << getId() << "|" << hourlyWage << "|" << hoursWorked << "|" << getName() << "\n";
         }
 };
 
@@ -140,208 +586,5673 @@ class ContractualEmployee : public Employee {
         }
         
         // Override displayPayrollReport method
-        void displayPayrollReport() const override {
-            cout << "Employee: " << getName() << " (ID: " << getId() << ")" << endl;
-            cout << "Contract Payment Per Project: $" << paymentPerProject << endl;
-            cout << "Projects Completed: " << projectsCompleted << endl;
-            cout << "Total Salary: $" << calculateSalary() << endl;
+        void displayPayrollReport(ostream& out) const override {
+            out << "Employee: " << getName() << " (ID: " << getId() << ")" << endl;
+            out << "Contract Payment Per Project: $" << paymentPerProject << endl;
+            out << "Projects Completed: " << projectsCompleted << endl;
+            out << "Total Salary: $" << calculateSalary() << endl;
         }
-};
-
-// PayrollSystem class to manage employees
-class PayrollSystem {
-    private:
-        vector<Employee*> employees;
         
-        // Helper function to check if an ID already exists
-        bool isIdUnique(const string& id) const {
-            return none_of(employees.begin(), employees.end(),
-                          [&id](const Employee* emp) { return emp->getId() == id; });
+        double getPaymentPerProject() const {
+            return paymentPerProject;
         }
         
-        // Helper function to get employee ID with validation
-        string getEmployeeId() {
-            string id;
-            bool validInput = false;
-            
-            while (!validInput) {
-                cout << "Enter Employee ID: ";
-                getline(cin, id);
-                
-                if (id.empty()) {
-                    cout << "ID cannot be empty. Please try again." << endl;
-                } else if (!isValidID(id)) {
-                    cout << "Invalid ID format! ID must contain only alphanumeric characters: ID must contain only letters and numbers with no spaces or special characters." << endl;
-                } else if (!isIdUnique(id)) {
-                    cout << "Duplicate ID! Please enter a unique ID." << endl;
-                } else {
-                    validInput = true;
-                }
-            }
-            return id;
+        int getProjectsCompleted() const {
+            return projectsCompleted;
         }
         
-        // Helper function to get employee name
-        string getEmployeeName() {
-            string name;
-            bool validInput = false;
-            
-            while (!validInput) {
-                cout << "Enter Employee Name: ";
-                getline(cin, name);
-                
-                if (!name.empty()) {
-                    validInput = true;
-                } else {
-                    cout << "Name cannot be empty. Please try again." << endl;
-                }
+        // Override writeRecord method
+        void writeRecord(ostream& out) const override {
+            out << "C|" << getId() << "|" << paymentPerProject << "|" << projectsCompleted << "|" << getName() << "\n";
+        }
+};
+
+// Parses one snapshot record line back into an employee; returns nullptr if the line is malformed
+Employee* parseEmployeeRecord(const string& line) {
+    vector<string> fields;
+    size_t start = 0;
+    // The name is the last field and may itself contain '|', so split at most the leading fields
+    size_t numericFields = (!line.empty() && line[0] == 'F') ? 1 : 2;
+    for (size_t i = 0; i < numericFields + 2; ++i) {
+        size_t end = line.find('|', start);
+        if (end == string::npos) {
+            return nullptr;
+        }
+        fields.push_back(line.substr(start, end - start));
+        start = end + 1;
+    }
+    string name = line.substr(start);
+    
+    if (fields[0].size() != 1 || !isValidID(fields[1]) || name.empty()) {
+        return nullptr;
+    }
+    try {
+        switch (fields[0][0]) {
+            case 'F':
+                return new FullTimeEmployee(fields[1], name, stod(fields[2]));
+            case 'P':
+                return new PartTimeEmployee(fields[1], name, stod(fields[2]), stod(fields[3]));
+            case 'C':
+                return new ContractualEmployee(fields[1], name, stod(fields[2]), stoi(fields[3]));
+        }
+    } catch (const exception&) {
+        return nullptr;
+    }
+    return nullptr;
+}
+
+// Header of a columnar snapshot chunk. Layout after the header (integers are 64-bit little-endian):
+//   employee count; length of the text section; text section of "id|name\n" lines;
+//   type column (0 full-time, 1 part-time, 2 contractual);
+//   amount column (salary, hourly wage or payment per project, in cents);
+//   quantity column (hours worked in cents, projects completed, or 0 for full-time).
+// Each numeric column is frame-of-reference encoded and bit-packed: base value, bit width,
+// then the packed offsets from the base.
+const string COLUMNAR_CHUNK_MAGIC = "PAYCOL2\n";
+
+// Converts an amount to whole cents if that is exact (always true for validated input)
+bool toExactCents(double value, int64_t& cents) {
+    if (!isfinite(value) || fabs(value) > 9.0e15) {
+        return false;
+    }
+    cents = llround(value * 100);
+    return static_cast<double>(cents) / 100 == value;
+}
+
+// Appends a 64-bit value in little-endian byte order
+void appendUint64(string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out += static_cast<char>((value >> (i * 8)) & 0xFF);
+    }
+}
+
+// Reads a 64-bit little-endian value from the front of the input
+bool readUint64(string_view& in, uint64_t& value) {
+    if (in.size() < 8) {
+        return false;
+    }
+    value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(in[i]);
+    }
+    in.remove_prefix(8);
+    return true;
+}
+
+// Columns of up to 32 bits are packed in four interleaved 32-bit lanes: value i goes to lane i % 4,
+// and each lane is a bit stream spread over 128-bit rows. Every lane of a row then needs the same
+// shift, so four values unpack with one SSE2 shift. Wider columns are packed in 64-bit words.
+const unsigned MAX_LANE_WIDTH = 32;
+
+// Number of bytes holding count values packed at a bit width
+size_t packedColumnBytes(size_t count, unsigned width) {
+    if (width <= MAX_LANE_WIDTH) {
+        return ((count + 3) / 4 * width + 31) / 32 * 16;
+    }
+    return (count * width + 63) / 64 * 8;
+}
+
+// Appends a frame-of-reference, bit-packed column
+void appendPackedColumn(string& out, const vector<int64_t>& values) {
+    int64_t base = values.empty() ? 0 : *min_element(values.begin(), values.end());
+    uint64_t range = 0;
+    for (int64_t value : values) {
+        range = max(range, static_cast<uint64_t>(value) - static_cast<uint64_t>(base));
+    }
+    unsigned width = 0;
+    while (width < 64 && (range >> width) != 0) {
+        ++width;
+    }
+    
+    // A constant column has width 0 and stores no words
+    vector<uint64_t> words(packedColumnBytes(values.size(), width) / 8, 0);
+    for (size_t i = 0; width > 0 && i < values.size(); ++i) {
+        uint64_t offset = static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(base);
+        if (width <= MAX_LANE_WIDTH) {
+            // Lane words are 32-bit; two of them share each 64-bit word, low half first
+            size_t bit = i / 4 * width, lane = i % 4;
+            size_t word = bit / 32 * 4 + lane;
+            words[word / 2] |= ((offset << (bit % 32)) & 0xFFFFFFFF) << (word % 2 * 32);
+            if (bit % 32 + width > 32) {
+                word += 4;
+                words[word / 2] |= (offset >> (32 - bit % 32)) << (word % 2 * 32);
+            }
+        } else {
+            size_t bit = i * width;
+            words[bit / 64] |= offset << (bit % 64);
+            if (bit % 64 + width > 64) {
+                words[bit / 64 + 1] |= offset >> (64 - bit % 64);
             }
-            return name;
         }
+    }
+    
+    appendUint64(out, static_cast<uint64_t>(base));
+    out += static_cast<char>(width);
+    for (uint64_t word : words) {
+        appendUint64(out, word);
+    }
+}
+
+// Loads 4 or 8 bytes as a little-endian value
+template <typename Word>
+inline Word loadLittleEndian(const char* bytes) {
+    Word value = 0;
+    for (size_t i = sizeof(Word); i-- > 0;) {
+        value = (value << 8) | static_cast<unsigned char>(bytes[i]);
+    }
+    return value;
+}
+
+// A frame-of-reference, bit-packed column read in place from a chunk
+struct PackedColumnView {
+    uint64_t base = 0;
+    unsigned width = 0;
+    string_view words; // The packed offsets (packedColumnBytes of the count)
+    
+#if defined(__SSE2__)
+    // Walks a column in lane layout four values at a time, yielding their offsets from the base one
+    // per 32-bit lane: shift the row right, then pull the straddling bits from the next row (a left
+    // shift by 32 clears every lane) and mask
+    class LaneReader {
+        private:
+            const __m128i* row;
+            const __m128i* rowsEnd;
+            int width;
+            int shift;
+            __m128i mask;
         
-        // Helper function to get valid decimal value (for salary and hours)
-        double getValidDecimalInput(const string& prompt) {
-            string input;
-            double value;
-            bool validInput = false;
+        public:
+            LaneReader(const PackedColumnView& column, size_t group)
+                : row(reinterpret_cast<const __m128i*>(column.words.data()) + group * column.width / 32),
+                  rowsEnd(reinterpret_cast<const __m128i*>(column.words.data()) + column.words.size() / 16),
+                  width(static_cast<int>(column.width)), shift(static_cast<int>(group * column.width % 32)),
+                  mask(_mm_set1_epi32(static_cast<int>(column.width == 32 ? ~0U : (1U << column.width) - 1))) {
+            }
             
-            while (!validInput) {
-                cout << prompt;
-                getline(cin, input);
-                
-                if (isValidDecimal(input, value)) {
-                    if (value > 0) {
-                        validInput = true;
-                    } else {
-                        cout << "Value must be greater than zero. Please try again." << endl;
-                    }
-                } else {
-                    cout << "Invalid format. Please enter a valid number." << endl;
+            __m128i next() {
+                if (width == 0) {
+                    return _mm_setzero_si128();
+                }
+                __m128i lanes = _mm_srl_epi32(_mm_loadu_si128(row), _mm_cvtsi32_si128(shift));
+                if (row + 1 < rowsEnd) {
+                    lanes = _mm_or_si128(lanes, _mm_sll_epi32(_mm_loadu_si128(row + 1), _mm_cvtsi32_si128(32 - shift)));
                 }
+                shift += width;
+                if (shift >= 32) {
+                    shift -= 32;
+                    ++row;
+                }
+                return _mm_and_si128(lanes, mask);
             }
-            return value;
+    };
+#endif
+    
+    // Unpacks values [first, first + n) into out
+    void unpack(size_t first, size_t n, int64_t* out) const {
+        size_t i = first, end = first + n;
+        if (width == 0) {
+            fill(out, out + n, static_cast<int64_t>(base));
+            return;
         }
-        
-        // Helper function to get valid number of projects
-        int getValidNumericInput(const string& prompt) {
-            string input;
-            int value;
-            bool validInput = false;
-            
-            while (!validInput) {
-                cout << prompt;
-                getline(cin, input);
-                
-                if (isValidInteger(input, value)) {
-                    if (value >= 0) {
-                        validInput = true;
-                    } else {
-                        cout << "Value cannot be negative. Please try again." << endl;
-                    }
-                } else {
-                    cout << "Invalid input. Please enter a valid number." << endl;
+        if (width > MAX_LANE_WIDTH) {
+            uint64_t mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+            for (; i < end; ++i) {
+                size_t bit = i * width;
+                unsigned shift = bit % 64;
+                uint64_t value = loadLittleEndian<uint64_t>(words.data() + bit / 64 * 8) >> shift;
+                if (shift + width > 64) {
+                    value |= loadLittleEndian<uint64_t>(words.data() + bit / 64 * 8 + 8) << (64 - shift);
                 }
+                out[i - first] = static_cast<int64_t>(base + (value & mask));
             }
-            return value;
+            return;
         }
         
-    public:
-        // Destructor to free memory
-        ~PayrollSystem() {
-            for (auto emp : employees) {
-                delete emp;
+        uint32_t mask = width == 32 ? ~0U : (1U << width) - 1;
+        auto unpackOne = [&](size_t index) {
+            size_t bit = index / 4 * width;
+            const char* lane = words.data() + (bit / 32 * 4 + index % 4) * 4;
+            uint32_t value = loadLittleEndian<uint32_t>(lane) >> (bit % 32);
+            if (bit % 32 + width > 32) {
+                value |= loadLittleEndian<uint32_t>(lane + 16) << (32 - bit % 32);
             }
+            out[index - first] = static_cast<int64_t>(base + (value & mask));
+        };
+        for (; i < end && i % 4 != 0; ++i) {
+            unpackOne(i);
         }
-        
-        // Function to add a full-time employee
-        void addFullTimeEmployee() {
-            string id = getEmployeeId();
-            string name = getEmployeeName();
+#if defined(__SSE2__)
+        // Four values per step, widened to 64 bits before adding the base
+        const __m128i base128 = _mm_set1_epi64x(static_cast<long long>(base));
+        const __m128i zero = _mm_setzero_si128();
+        LaneReader reader(*this, i / 4);
+        for (; end - i >= 4; i += 4) {
+            __m128i lanes = reader.next();
+            __m128i* target = reinterpret_cast<__m128i*>(out + (i - first));
+            _mm_storeu_si128(target, _mm_add_epi64(_mm_unpacklo_epi32(lanes, zero), base128));
+            _mm_storeu_si128(target + 1, _mm_add_epi64(_mm_unpackhi_epi32(lanes, zero), base128));
+        }
+#endif
+        for (; i < end; ++i) {
+            unpackOne(i);
+        }
+    }
+};
+
+// Reads a frame-of-reference, bit-packed column of count values (unpacked on demand)
+bool readPackedColumn(string_view& in, size_t count, PackedColumnView& column) {
+    if (!readUint64(in, column.base) || in.empty()) {
+        return false;
+    }
+    column.width = static_cast<unsigned char>(in[0]);
+    in.remove_prefix(1);
+    if (column.width > 64 || (column.width > 0 && count > in.size() * 8)) {
+        return false;
+    }
+    size_t byteCount = packedColumnBytes(count, column.width);
+    if (in.size() < byteCount) {
+        return false;
+    }
+    column.words = in.substr(0, byteCount);
+    in.remove_prefix(byteCount);
+    return true;
+}
+
+// Byte offset and width of one field in a fixed-width record
+struct FixedWidthField {
+    size_t offset;
+    size_t width;
+};
+
+// Field positions of the legacy HR fixed-width export. amount is the salary, hourly wage or
+// payment per project; quantity is hours worked (part-time) or projects completed (contractual).
+struct FixedWidthLayout {
+    FixedWidthField type = {0, 1};
+    FixedWidthField id = {1, 10};
+    FixedWidthField name = {11, 30};
+    FixedWidthField amount = {41, 12};
+    FixedWidthField quantity = {53, 12};
+};
+
+// Reads a layout file with lines of the form "<field> <offset> <width>"; unlisted fields keep their defaults
+bool loadFixedWidthLayout(const string& path, FixedWidthLayout& layout) {
+    ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    string field;
+    size_t offset, width;
+    while (in >> field >> offset >> width) {
+        FixedWidthField slot = {offset, width};
+        if (field == "type") {
+            layout.type = slot;
+        } else if (field == "id") {
+            layout.id = slot;
+        } else if (field == "name") {
+            layout.name = slot;
+        } else if (field == "amount") {
+            layout.amount = slot;
+        } else if (field == "quantity") {
+            layout.quantity = slot;
+        } else {
+            return false;
+        }
+    }
+    return in.eof();
+}
+
+// Slices a field out of a record without copying, trimming the space padding
+string_view sliceField(string_view record, const FixedWidthField& field) {
+    if (field.offset >= record.size()) {
+        return string_view();
+    }
+    string_view value = record.substr(field.offset, field.width);
+    size_t first = value.find_first_not_of(' ');
+    if (first == string_view::npos) {
+        return string_view();
+    }
+    return value.substr(first, value.find_last_not_of(' ') - first + 1);
+}
+
+// Creates an employee from its fields as text, with the same rules as interactive entry. Type is
+// F (salary), P (hourly wage, hours worked) or C (payment per project, projects completed).
+// Fields are validated in place; only the ID and name the employee keeps are copied.
+// Returns nullptr and sets the reason if a field is invalid.
+Employee* createValidatedEmployee(string_view type, string_view id, string_view name,
+                                  string_view amountText, string_view quantityText, string& error) {
+    double amount, hours;
+    int projects;
+    if (type != "F" && type != "P" && type != "C") {
+        error = "unknown employee type";
+    } else if (!isValidID(id)) {
+        error = "invalid ID";
+    } else if (name.empty()) {
+        error = "empty name";
+    } else if (name.find_first_of("\r\n") != string_view::npos) {
+        error = "name contains a line break"; // Console input can never contain one
+    } else if (!isValidDecimal(amountText, amount) || amount <= 0) {
+        error = "invalid amount";
+    } else if (type == "F") {
+        return new FullTimeEmployee(string(id), string(name), amount);
+    } else if (type == "P") {
+        if (isValidDecimal(quantityText, hours) && hours > 0) {
+            return new PartTimeEmployee(string(id), string(name), amount, hours);
+        }
+        error = "invalid hours worked";
+    } else {
+        if (isValidInteger(quantityText, projects) && projects >= 0) {
+            return new ContractualEmployee(string(id), string(name), amount, projects);
+        }
+        error = "invalid projects completed";
+    }
+    return nullptr;
+}
+
+// Parses one fixed-width record with the same rules as interactive entry; returns nullptr and
+// sets the reason if the record is invalid
+Employee* parseFixedWidthRecord(string_view record, const FixedWidthLayout& layout, string& error) {
+    return createValidatedEmployee(sliceField(record, layout.type), sliceField(record, layout.id),
+                                   sliceField(record, layout.name), sliceField(record, layout.amount),
+                                   sliceField(record, layout.quantity), error);
+}
+
+// Returns the position of the next '"', '\\' or control character at or after p (or end). This is
+// the hot loop of JSON string scanning, so it checks 16 bytes at a time with SSE2 where available.
+const char* findStringSpecial(const char* p, const char* end) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i lastControl = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // Unsigned byte <= 0x1F exactly when max(byte, 0x1F) == 0x1F
+        __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(block, lastControl), lastControl);
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)), control));
+        if (mask != 0) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) {
+        ++p;
+    }
+    return p;
+}
+
+// Minimal scanner over one flat JSON object, extracting values without building a DOM
+class JsonScanner {
+    private:
+        const char* p;
+        const char* end;
+        
+        // Helper function to append a code point as UTF-8
+        static void appendUtf8(string& out, unsigned codePoint) {
+            if (codePoint < 0x80) {
+                out += static_cast<char>(codePoint);
+            } else if (codePoint < 0x800) {
+                out += static_cast<char>(0xC0 | (codePoint >> 6));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else if (codePoint < 0x10000) {
+                out += static_cast<char>(0xE0 | (codePoint >> 12));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (codePoint >> 18));
+                out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+        
+        // Helper function to read the four hex digits of a unicode escape
+        bool readHex4(unsigned& value) {
+            if (end - p < 4) {
+                return false;
+            }
+            value = 0;
+            for (int i = 0; i < 4; ++i, ++p) {
+                char c = *p;
+                value <<= 4;
+                if (c >= '0' && c <= '9') {
+                    value |= c - '0';
+                } else if (c >= 'a' && c <= 'f') {
+                    value |= c - 'a' + 10;
+                } else if (c >= 'A' && c <= 'F') {
+                    value |= c - 'A' + 10;
+                } else {
+                    return false;
+                }
+            }
+            return true;
+        }
+        
+    public:
+        JsonScanner(string_view text) : p(text.data()), end(text.data() + text.size()) {}
+        
+        void skipWhitespace() {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+                ++p;
+            }
+        }
+        
+        // Consumes the given structural character (after whitespace) if it is next
+        bool consume(char c) {
+            skipWhitespace();
+            if (p < end && *p == c) {
+                ++p;
+                return true;
+            }
+            return false;
+        }
+        
+        bool atEnd() {
+            skipWhitespace();
+            return p == end;
+        }
+        
+        // Reads a string (the opening quote is next), decoding escapes. Control characters (raw or
+        // escaped) and unpaired surrogates are rejected: employee names are stored one per line.
+        bool readString(string& out) {
+            if (!consume('"')) {
+                return false;
+            }
+            out.clear();
+            while (true) {
+                const char* stop = findStringSpecial(p, end);
+                out.append(p, stop);
+                p = stop;
+                if (p == end || static_cast<unsigned char>(*p) < 0x20) {
+                    return false;
+                }
+                if (*p++ == '"') {
+                    return true;
+                }
+                if (p == end) {
+                    return false;
+                }
+                char escape = *p++;
+                unsigned codePoint;
+                switch (escape) {
+                    case '"': out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/': out += '/'; break;
+                    case 'u':
+                        if (!readHex4(codePoint) || codePoint < 0x20 || (codePoint >= 0xDC00 && codePoint <= 0xDFFF)) {
+                            return false;
+                        }
+                        // A high surrogate must be followed by a low one; combine them into one code point
+                        if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                            if (end - p < 6 || p[0] != '\\' || p[1] != 'u') {
+                                return false;
+                            }
+                            p += 2;
+                            unsigned low;
+                            if (!readHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+                                return false;
+                            }
+                            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        appendUtf8(out, codePoint);
+                        break;
+                    default:
+                        // Includes \b, \f, \n, \r and \t, which only encode control characters
+                        return false;
+                }
+            }
+        }
+        
+        // Reads any value: strings are decoded, numbers and literals are returned as their raw text,
+        // and nested objects or arrays are skipped (returned as empty text)
+        bool readValue(string& out) {
+            skipWhitespace();
+            if (p == end) {
+                return false;
+            }
+            if (*p == '"') {
+                return readString(out);
+            }
+            if (*p == '{' || *p == '[') {
+                int depth = 0;
+                while (p < end) {
+                    if (*p == '"') {
+                        string ignored;
+                        if (!readString(ignored)) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    if (*p == '{' || *p == '[') {
+                        ++depth;
+                    } else if (*p == '}' || *p == ']') {
+                        if (--depth == 0) {
+                            ++p;
+                            out.clear();
+                            return true;
+                        }
+                    }
+                    ++p;
+                }
+                return false;
+            }
+            const char* start = p;
+            while (p < end && *p != ',' && *p != '}' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+                ++p;
+            }
+            out.assign(start, p);
+            return !out.empty();
+        }
+};
+
+// Parses one NDJSON employee object, e.g.
+//   {"id":"A1","name":"Ann","type":"part-time","hourlyWage":12.5,"hoursWorked":40}
+// Types are full-time (salary), part-time (hourlyWage, hoursWorked) and contractual
+// (paymentPerProject, projectsCompleted); pay values may be numbers or strings. Fields are
+// validated by createValidatedEmployee, like every other import path. Returns nullptr and sets
+// the reason if invalid.
+Employee* parseNdjsonRecord(string_view record, string& error) {
+    JsonScanner scanner(record);
+    string id, name, type, salary, hourlyWage, hoursWorked, paymentPerProject, projectsCompleted;
+    
+    if (!scanner.consume('{')) {
+        error = "expected a JSON object";
+        return nullptr;
+    }
+    if (!scanner.consume('}')) {
+        do {
+            string key, value;
+            if (!scanner.readString(key) || !scanner.consume(':') || !scanner.readValue(value)) {
+                error = "malformed JSON or a control character in a string";
+                return nullptr;
+            }
+            if (key == "id") {
+                id = value;
+            } else if (key == "name") {
+                name = value;
+            } else if (key == "type") {
+                type = value;
+            } else if (key == "salary") {
+                salary = value;
+            } else if (key == "hourlyWage") {
+                hourlyWage = value;
+            } else if (key == "hoursWorked") {
+                hoursWorked = value;
+            } else if (key == "paymentPerProject") {
+                paymentPerProject = value;
+            } else if (key == "projectsCompleted") {
+                projectsCompleted = value;
+            }
+        } while (scanner.consume(','));
+        if (!scanner.consume('}')) {
+            error = "malformed JSON";
+            return nullptr;
+        }
+    }
+    if (!scanner.atEnd()) {
+        error = "unexpected text after the JSON object";
+        return nullptr;
+    }
+    
+    // Map the JSON type name and its pay fields onto the F/P/C record fields
+    if (type == "full-time" || type == "F") {
+        return createValidatedEmployee("F", id, name, salary, string_view(), error);
+    }
+    if (type == "part-time" || type == "P") {
+        return createValidatedEmployee("P", id, name, hourlyWage, hoursWorked, error);
+    }
+    if (type == "contractual" || type == "C") {
+        return createValidatedEmployee("C", id, name, paymentPerProject, projectsCompleted, error);
+    }
+    return createValidatedEmployee(type, id, name, string_view(), string_view(), error);
+}
+
+// Encodes employees as a columnar snapshot chunk; returns false if a pay value has more than
+// two decimal places (the chunk is then stored as text records instead)
+bool encodeColumnarChunk(const Employee* const* emps, size_t count, string& out) {
+    string text;
+    vector<int64_t> types(count), amounts(count), quantities(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        const Employee* emp = emps[i];
+        if (auto fullTime = dynamic_cast<const FullTimeEmployee*>(emp)) {
+            types[i] = 0;
+            if (!toExactCents(fullTime->getSalary(), amounts[i])) {
+                return false;
+            }
+        } else if (auto partTime = dynamic_cast<const PartTimeEmployee*>(emp)) {
+            types[i] = 1;
+            if (!toExactCents(partTime->getHourlyWage(), amounts[i]) ||
+                !toExactCents(partTime->getHoursWorked(), quantities[i])) {
+                return false;
+            }
+        } else if (auto contractual = dynamic_cast<const ContractualEmployee*>(emp)) {
+            types[i] = 2;
+            if (!toExactCents(contractual->getPaymentPerProject(), amounts[i])) {
+                return false;
+            }
+            quantities[i] = contractual->getProjectsCompleted();
+        } else {
+            return false;
+        }
+        text += emp->getId();
+        text += '|';
+        text += emp->getName();
+        text += '\n';
+    }
+    
+    out = COLUMNAR_CHUNK_MAGIC;
+    appendUint64(out, count);
+    appendUint64(out, text.size());
+    out += text;
+    appendPackedColumn(out, types);
+    appendPackedColumn(out, amounts);
+    appendPackedColumn(out, quantities);
+    return true;
+}
+
+// Columns of a columnar snapshot chunk, read in place
+struct ColumnarChunk {
+    size_t count = 0;
+    string_view text;
+    PackedColumnView types, amounts, quantities;
+};
+
+// Helper function to split a columnar snapshot chunk into its sections; returns false if it is malformed
+bool readColumnarChunk(string_view data, ColumnarChunk& chunk) {
+    uint64_t count, textSize;
+    data.remove_prefix(COLUMNAR_CHUNK_MAGIC.size());
+    if (!readUint64(data, count) || !readUint64(data, textSize) || textSize > data.size() || count > textSize) {
+        return false;
+    }
+    chunk.count = count;
+    chunk.text = data.substr(0, textSize);
+    data.remove_prefix(textSize);
+    return readPackedColumn(data, count, chunk.types) && readPackedColumn(data, count, chunk.amounts) &&
+           readPackedColumn(data, count, chunk.quantities);
+}
+
+// Decodes a columnar snapshot chunk into new employees; returns false if it is malformed
+bool decodeColumnarChunk(string_view data, vector<Employee*>& decoded) {
+    ColumnarChunk chunk;
+    if (!readColumnarChunk(data, chunk)) {
+        return false;
+    }
+    vector<int64_t> types(chunk.count), amounts(chunk.count), quantities(chunk.count);
+    chunk.types.unpack(0, chunk.count, types.data());
+    chunk.amounts.unpack(0, chunk.count, amounts.data());
+    chunk.quantities.unpack(0, chunk.count, quantities.data());
+    
+    string_view text = chunk.text;
+    for (size_t i = 0; i < chunk.count; ++i) {
+        size_t lineEnd = text.find('\n');
+        size_t idEnd = text.find('|');
+        if (lineEnd == string_view::npos || idEnd == string_view::npos || idEnd > lineEnd) {
+            return false;
+        }
+        string id(text.substr(0, idEnd));
+        string name(text.substr(idEnd + 1, lineEnd - idEnd - 1));
+        text.remove_prefix(lineEnd + 1);
+        if (!isValidID(id) || name.empty()) {
+            return false;
+        }
+        
+        double amount = static_cast<double>(amounts[i]) / 100;
+        if (types[i] == 0) {
+            decoded.push_back(new FullTimeEmployee(id, name, amount));
+        } else if (types[i] == 1) {
+            decoded.push_back(new PartTimeEmployee(id, name, amount, static_cast<double>(quantities[i]) / 100));
+        } else if (types[i] == 2 && quantities[i] >= 0 && quantities[i] <= numeric_limits<int>::max()) {
+            decoded.push_back(new ContractualEmployee(id, name, amount, static_cast<int>(quantities[i])));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sums the pay of the employees in a columnar snapshot chunk straight from its columns; returns
+// false if the chunk is malformed. Pay is summed in hundredths of a cent: the amount in cents times
+// 100 for full-time, times the hours in cents for part-time, times 100 per project for contractual.
+bool sumColumnarChunkPay(string_view data, double& total) {
+    const size_t BLOCK = 256;
+    ColumnarChunk chunk;
+    if (!readColumnarChunk(data, chunk) || chunk.types.base > 2) {
+        return false;
+    }
+    double sum = 0;
+    size_t first = 0;
+#if defined(__SSE2__)
+    // Four employees per step, unpacked into registers, while every offset converts exactly from a
+    // signed 32-bit lane
+    if (chunk.types.width < 32 && chunk.amounts.width < 32 && chunk.quantities.width < 32) {
+        const __m128i typeBase = _mm_set1_epi32(static_cast<int>(chunk.types.base));
+        const __m128d amountBase = _mm_set1_pd(static_cast<double>(static_cast<int64_t>(chunk.amounts.base)));
+        const __m128d quantityBase = _mm_set1_pd(static_cast<double>(static_cast<int64_t>(chunk.quantities.base)));
+        const __m128d hundred = _mm_set1_pd(100);
+        __m128d sumLow = _mm_setzero_pd(), sumHigh = _mm_setzero_pd();
+        __m128i invalid = _mm_setzero_si128();
+        PackedColumnView::LaneReader typeLanes(chunk.types, 0), amountLanes(chunk.amounts, 0), quantityLanes(chunk.quantities, 0);
+        for (; chunk.count - first >= 4; first += 4) {
+            __m128i types = _mm_add_epi32(typeLanes.next(), typeBase);
+            __m128i amounts = amountLanes.next();
+            __m128i quantities = quantityLanes.next();
+            invalid = _mm_or_si128(invalid, _mm_or_si128(_mm_cmpgt_epi32(types, _mm_set1_epi32(2)), _mm_cmplt_epi32(types, _mm_setzero_si128())));
+            __m128i fullTime = _mm_cmpeq_epi32(types, _mm_setzero_si128());
+            __m128i partTime = _mm_cmpeq_epi32(types, _mm_set1_epi32(1));
+            
+            // Lanes 0-1, then lanes 2-3, as doubles with 64-bit select masks
+            for (int half = 0; half < 2; ++half) {
+                __m128i amountPair = half == 0 ? amounts : _mm_shuffle_epi32(amounts, 0xEE);
+                __m128i quantityPair = half == 0 ? quantities : _mm_shuffle_epi32(quantities, 0xEE);
+                __m128d fullMask = _mm_castsi128_pd(half == 0 ? _mm_unpacklo_epi32(fullTime, fullTime) : _mm_unpackhi_epi32(fullTime, fullTime));
+                __m128d partMask = _mm_castsi128_pd(half == 0 ? _mm_unpacklo_epi32(partTime, partTime) : _mm_unpackhi_epi32(partTime, partTime));
+                __m128d amount = _mm_add_pd(_mm_cvtepi32_pd(amountPair), amountBase);
+                __m128d quantity = _mm_add_pd(_mm_cvtepi32_pd(quantityPair), quantityBase);
+                __m128d factor = _mm_or_pd(_mm_and_pd(partMask, quantity), _mm_andnot_pd(partMask, _mm_mul_pd(quantity, hundred)));
+                factor = _mm_or_pd(_mm_and_pd(fullMask, hundred), _mm_andnot_pd(fullMask, factor));
+                if (half == 0) {
+                    sumLow = _mm_add_pd(sumLow, _mm_mul_pd(amount, factor));
+                } else {
+                    sumHigh = _mm_add_pd(sumHigh, _mm_mul_pd(amount, factor));
+                }
+            }
+        }
+        if (_mm_movemask_epi8(invalid) != 0) {
+            return false;
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_add_pd(sumLow, sumHigh));
+        sum = lanes[0] + lanes[1];
+    }
+#endif
+    
+    // Remaining employees a block at a time
+    int64_t types[BLOCK], amounts[BLOCK], quantities[BLOCK];
+    for (; first < chunk.count; first += BLOCK) {
+        size_t n = min(BLOCK, chunk.count - first);
+        chunk.types.unpack(first, n, types);
+        chunk.amounts.unpack(first, n, amounts);
+        chunk.quantities.unpack(first, n, quantities);
+        for (size_t i = 0; i < n; ++i) {
+            if (types[i] < 0 || types[i] > 2) {
+                return false;
+            }
+            int64_t factor = types[i] == 0 ? 100 : (types[i] == 1 ? quantities[i] : quantities[i] * 100);
+            sum += static_cast<double>(amounts[i]) * static_cast<double>(factor);
+        }
+    }
+    total += sum / 10000;
+    return true;
+}
+
+// Writes a file atomically (write to a temporary, then rename)
+bool writeFileAtomically(const filesystem::path& path, const function<bool(ostream&)>& write) {
+    filesystem::path temp = path;
+    temp += ".tmp";
+    {
+        ofstream out(temp, ios::binary | ios::trunc);
+        if (!out || !write(out) || !out.flush()) {
+            return false;
+        }
+    }
+    error_code ec;
+    filesystem::rename(temp, path, ec);
+    return !ec;
+}
+
+// Helper function to write a whole buffer to a file atomically
+bool writeFileAtomically(const filesystem::path& path, const string& data) {
+    return writeFileAtomically(path, [&data](ostream& out) { return static_cast<bool>(out.write(data.data(), data.size())); });
+}
+
+// Estimates the heap memory held by one employee record (object, strings and roster slot)
+size_t estimateEmployeeBytes(const Employee* emp) {
+    return sizeof(ContractualEmployee) + sizeof(Employee*) + emp->getId().size() + emp->getName().size();
+}
+
+// Estimates the memory for a batch of employees from their serialized records; an upper bound
+// in practice, as each record's text holds the employee's ID and name plus its other fields
+size_t estimateBatchBytes(size_t count, size_t recordBytes) {
+    return count * (sizeof(ContractualEmployee) + sizeof(Employee*)) + recordBytes;
+}
+
+// Memory budget for employee records, which several rosters may share (e.g. scheduled jobs running
+// side by side). A reservation that does not fit applies backpressure: the loader waits while some
+// other roster holding memory is still running and will release it. It is refused only if it could
+// never fit, or if every other holder is waiting too. Time spent waiting is kept for reporting.
+class MemoryBudget {
+    private:
+        mutable mutex lock;
+        condition_variable changed;
+        size_t limit = 0;   // 0 means unlimited
+        size_t inUse = 0;
+        size_t peak = 0;
+        size_t holders = 0; // Rosters holding any memory
+        size_t waitingHolders = 0; // Holders waiting for more memory
+        size_t throttled = 0;
+        size_t refused = 0;
+        double throttledSeconds = 0;
+        
+    public:
+        void setLimit(size_t bytes) {
+            lock_guard<mutex> guard(lock);
+            limit = bytes;
+            changed.notify_all();
+        }
+        
+        size_t getLimit() const {
+            lock_guard<mutex> guard(lock);
+            return limit;
+        }
+        
+        size_t getInUse() const {
+            lock_guard<mutex> guard(lock);
+            return inUse;
+        }
+        
+        // Checks whether extra bytes would fit right now, without reserving them
+        bool fits(size_t extraBytes) const {
+            lock_guard<mutex> guard(lock);
+            return limit == 0 || inUse + extraBytes <= limit;
+        }
+        
+        // Reserves bytes for a roster, which holds no memory yet if firstHold is set. Waits while the
+        // bytes do not fit and another holder is still running; returns false if they cannot be had.
+        bool reserve(size_t bytes, bool firstHold) {
+            unique_lock<mutex> guard(lock);
+            auto fitsNow = [this, bytes] { return limit == 0 || inUse + bytes <= limit; };
+            size_t self = firstHold ? 0 : 1;
+            if (!fitsNow() && bytes <= limit && holders - waitingHolders > self) {
+                auto waitStart = chrono::steady_clock::now();
+                waitingHolders += self;
+                ++throttled;
+                changed.notify_all(); // Holders already waiting re-check whether anyone is left running
+                changed.wait(guard, [this, &fitsNow] { return fitsNow() || holders == waitingHolders; });
+                waitingHolders -= self;
+                throttledSeconds += chrono::duration<double>(chrono::steady_clock::now() - waitStart).count();
+            }
+            if (!fitsNow()) {
+                ++refused;
+                changed.notify_all();
+                return false;
+            }
+            inUse += bytes;
+            peak = max(peak, inUse);
+            if (firstHold && bytes > 0) {
+                ++holders;
+            }
+            return true;
+        }
+        
+        // Returns bytes to the budget; lastHold is set once the roster holds nothing
+        void release(size_t bytes, bool lastHold) {
+            lock_guard<mutex> guard(lock);
+            inUse -= bytes;
+            if (lastHold && bytes > 0) {
+                --holders;
+            }
+            changed.notify_all();
+        }
+        
+        void printSummary(ostream& out) const {
+            lock_guard<mutex> guard(lock);
+            out << fixed << setprecision(1) << "Memory budget: " << limit / (1024.0 * 1024.0) << " MB, peak "
+                << peak / (1024.0 * 1024.0) << " MB, " << throttled << " reservation(s) throttled for "
+                << throttledSeconds * 1000 << " ms, " << refused << " refused" << endl;
+            out.unsetf(ios::floatfield);
+        }
+};
+
+// Formats an amount of money with two decimal places
+string formatMoney(double amount) {
+    ostringstream out;
+    out << fixed << setprecision(2) << amount;
+    return out.str();
+}
+
+// Breaks a time into local calendar fields (safe to call from any thread, unlike localtime)
+tm localCalendarTime(time_t when) {
+    tm parts = {};
+#ifdef _WIN32
+    localtime_s(&parts, &when);
+#else
+    localtime_r(&when, &parts);
+#endif
+    return parts;
+}
+
+// Formats a time as a local calendar date, YYYY-MM-DD
+string formatPayDate(time_t when) {
+    tm parts = localCalendarTime(when);
+    char date[16];
+    strftime(date, sizeof(date), "%Y-%m-%d", &parts);
+    return date;
+}
+
+// Records every input line with its time since the session started, or replays a recorded
+// session in place of the console (at full speed or with the recorded pauses), and collects
+// per-command latencies excluding time spent waiting for input.
+class ConsoleSession {
+    private:
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ofstream recording;
+        vector<pair<double, string>> replayLines; // Recorded offset in seconds, then the line
+        size_t nextReplayLine = 0;
+        bool replaying = false;
+        bool realTime = false;
+        double inputWaitSeconds = 0;
+        map<string, vector<double>> commandSeconds;
+        
+        double elapsed() const {
+            return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        }
+        
+        // Helper function to build the first line of a session file. The menu version is part of
+        // it because a session only means the same thing against the same menu numbering.
+        static string sessionHeader(int menuVersion) {
+            return "# Payroll session format 2, menu " + to_string(menuVersion) +
+                   ": seconds since start, a tab, then the input line";
+        }
+        
+    public:
+        // Starts recording input lines to a session file
+        bool startRecording(const string& path, int menuVersion) {
+            recording.open(path, ios::trunc);
+            recording << sessionHeader(menuVersion) << "\n";
+            recording.precision(6);
+            return static_cast<bool>(recording);
+        }
+        
+        // Loads a recorded session to be read instead of the console; fails with a reason if the
+        // file is not a session recorded against this menu version
+        bool startReplay(const string& path, int menuVersion, bool withRecordedPauses, string& error) {
+            ifstream in(path);
+            if (!in) {
+                error = "unable to open the file";
+                return false;
+            }
+            string line;
+            if (!getline(in, line) || line != sessionHeader(menuVersion)) {
+                error = "not recorded with this version of the menu (expected \"" + sessionHeader(menuVersion) + "\")";
+                return false;
+            }
+            while (getline(in, line)) {
+                size_t tab = line.find('\t');
+                if (line.empty() || line[0] == '#' || tab == string::npos) {
+                    continue;
+                }
+                try {
+                    replayLines.emplace_back(stod(line.substr(0, tab)), line.substr(tab + 1));
+                } catch (const exception&) {
+                    error = "malformed line: " + line.substr(0, 40);
+                    return false;
+                }
+            }
+            replaying = true;
+            realTime = withRecordedPauses;
+            start = chrono::steady_clock::now();
+            return true;
+        }
+        
+        bool isReplaying() const {
+            return replaying;
+        }
+        
+        // Returns the next recorded line, in real-time mode once its recorded offset is reached
+        bool readReplayLine(string& line) {
+            if (nextReplayLine >= replayLines.size()) {
+                return false;
+            }
+            if (realTime) {
+                this_thread::sleep_until(start + chrono::duration_cast<chrono::steady_clock::duration>(
+                    chrono::duration<double>(replayLines[nextReplayLine].first)));
+            }
+            line = replayLines[nextReplayLine++].second;
+            if (line.size() > MAX_INPUT_LINE) {
+                cout << "Input too long (maximum " << MAX_INPUT_LINE << " characters)." << endl;
+                line.clear(); // Same bound as console input
+            }
+            return true;
+        }
+        
+        // Notes a line returned to the program and the time spent waiting for it
+        void inputReceived(const string& line, double waitSeconds) {
+            inputWaitSeconds += waitSeconds;
+            if (recording.is_open()) {
+                recording << fixed << elapsed() << '\t' << line << endl;
+            }
+        }
+        
+        // Total time spent waiting for input, so it can be excluded from command latency
+        double getInputWaitSeconds() const {
+            return inputWaitSeconds;
+        }
+        
+        void recordCommand(const string& command, double seconds) {
+            commandSeconds[command].push_back(seconds);
+        }
+        
+        // Prints throughput and per-command latency (count, mean, median, 95th percentile, max)
+        void printSummary(ostream& out) {
+            double total = elapsed();
+            size_t commands = 0;
+            for (const auto& entry : commandSeconds) {
+                commands += entry.second.size();
+            }
+            out << "\nReplayed " << nextReplayLine << " input line(s), " << commands << " command(s) in "
+                << formatMoney(total) << "s (" << formatMoney(total > 0 ? commands / total : 0) << " commands/s)" << endl;
+            out << left << setw(28) << "command" << right << setw(8) << "count" << setw(12) << "mean ms"
+                << setw(12) << "p50 ms" << setw(12) << "p95 ms" << setw(12) << "max ms" << endl;
+            for (auto& entry : commandSeconds) {
+                vector<double>& samples = entry.second;
+                sort(samples.begin(), samples.end());
+                double sum = 0;
+                for (double sample : samples) {
+                    sum += sample;
+                }
+                auto percentile = [&samples](double p) {
+                    return samples[min(samples.size() - 1, static_cast<size_t>(p * samples.size()))];
+                };
+                out << left << setw(28) << entry.first << right << setw(8) << samples.size()
+                    << setw(12) << formatMoney(sum / samples.size() * 1000) << setw(12) << formatMoney(percentile(0.5) * 1000)
+                    << setw(12) << formatMoney(percentile(0.95) * 1000) << setw(12) << formatMoney(samples.back() * 1000) << endl;
+            }
+        }
+};
+
+// Session recording/replay for the console input
+ConsoleSession consoleSession;
+
+// Reads one line of input from the console, or from the session being replayed
+string readInputLine() {
+    auto waitStart = chrono::steady_clock::now();
+    string line;
+    if (!consoleSession.isReplaying()) {
+        line = readConsoleLine();
+    } else if (!consoleSession.readReplayLine(line)) {
+        throw InputClosedError();
+    }
+    consoleSession.inputReceived(line, chrono::duration<double>(chrono::steady_clock::now() - waitStart).count());
+    return line;
+}
+
+// Runs a graph of dependent tasks on a shared pool of worker threads, timing each stage.
+// A task becomes ready once all of its dependencies have finished.
+class TaskGraph {
+    private:
+        struct Task {
+            string stage;
+            function<void()> work;
+            vector<size_t> dependents;
+            size_t pendingDependencies = 0;
+        };
+        
+        vector<Task> tasks;
+        vector<pair<string, double>> stageSeconds; // Busy time per stage, in first-added order
+        
+        // Helper function to find (or add) the timing slot for a stage
+        size_t stageSlot(const string& stage) {
+            for (size_t i = 0; i < stageSeconds.size(); ++i) {
+                if (stageSeconds[i].first == stage) {
+                    return i;
+                }
+            }
+            stageSeconds.emplace_back(stage, 0.0);
+            return stageSeconds.size() - 1;
+        }
+        
+    public:
+        // Adds a task that runs after the given tasks; returns its handle for use as a dependency
+        size_t addTask(const string& stage, function<void()> work, const vector<size_t>& dependencies = {}) {
+            stageSlot(stage);
+            Task task;
+            task.stage = stage;
+            task.work = move(work);
+            task.pendingDependencies = dependencies.size();
+            tasks.push_back(move(task));
+            for (size_t dependency : dependencies) {
+                tasks[dependency].dependents.push_back(tasks.size() - 1);
+            }
+            return tasks.size() - 1;
+        }
+        
+        // Runs every task on the given number of threads; rethrows the first task exception
+        void run(size_t threadCount) {
+            mutex lock;
+            condition_variable changed;
+            deque<size_t> ready;
+            size_t remaining = tasks.size();
+            exception_ptr failure;
+            
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                if (tasks[i].pendingDependencies == 0) {
+                    ready.push_back(i);
+                }
+            }
+            
+            auto worker = [&]() {
+                unique_lock<mutex> guard(lock);
+                while (true) {
+                    changed.wait(guard, [&]() { return !ready.empty() || remaining == 0 || failure; });
+                    if (remaining == 0 || failure) {
+                        return;
+                    }
+                    size_t current = ready.front();
+                    ready.pop_front();
+                    guard.unlock();
+                    
+                    auto start = chrono::steady_clock::now();
+                    exception_ptr error;
+                    try {
+                        tasks[current].work();
+                    } catch (...) {
+                        error = current_exception();
+                    }
+                    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                    
+                    guard.lock();
+                    stageSeconds[stageSlot(tasks[current].stage)].second += seconds;
+                    if (error && !failure) {
+                        failure = error;
+                    }
+                    for (size_t dependent : tasks[current].dependents) {
+                        if (--tasks[dependent].pendingDependencies == 0) {
+                            ready.push_back(dependent);
+                        }
+                    }
+                    --remaining;
+                    changed.notify_all();
+                }
+            };
+            
+            vector<thread> threads;
+            for (size_t i = 1; i < max<size_t>(1, threadCount); ++i) {
+                threads.emplace_back(worker);
+            }
+            worker(); // The calling thread works too
+            for (auto& t : threads) {
+                t.join();
+            }
+            if (failure) {
+                rethrow_exception(failure);
+            }
+        }
+        
+        // Busy seconds spent in each stage across all threads
+        const vector<pair<string, double>>& getStageSeconds() const {
+            return stageSeconds;
+        }
+};
+
+// Decides how a sweep over many items runs: serially when the work is too small to repay
+// starting threads, otherwise on enough threads to amortize their start-up cost, in chunks
+// large enough to outweigh scheduling overhead. Per-item costs of each kind of sweep are
+// calibrated at startup and refined from every completed sweep.
+class AdaptiveExecutor {
+    public:
+        struct Policy {
+            size_t threads;
+            size_t chunkSize;
+        };
+        
+    private:
+        static constexpr double MIN_CHUNK_SECONDS = 0.0005;    // Work per chunk, so scheduling stays cheap
+        static constexpr double THREAD_PAYOFF = 20;            // A thread must do this many times its start-up cost
+        static constexpr double DEFAULT_ITEM_SECONDS = 1e-6;   // Assumed cost for a sweep never measured
+        static constexpr size_t CHUNKS_PER_THREAD = 4;         // Spare chunks for load balancing
+        
+        mutable mutex lock;
+        map<string, double> itemSeconds;                       // Measured cost per item, by kind of sweep
+        double threadStartSeconds = 50e-6;                     // Cost to start and join one worker thread
+        size_t hardwareThreads = max(1u, thread::hardware_concurrency());
+        
+        // Helper function to time a calibration loop, returning the seconds per iteration
+        template <typename Work>
+        static double timePerIteration(size_t iterations, Work work) {
+            auto start = chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                work(i);
+            }
+            return chrono::duration<double>(chrono::steady_clock::now() - start).count() / iterations;
+        }
+        
+    public:
+        // Measures thread start-up cost and the per-item cost of each built-in sweep on sample records
+        void calibrate() {
+            double startSeconds = timePerIteration(4, [](size_t) {
+                thread worker([]() {});
+                worker.join();
+            });
+            
+            FullTimeEmployee sample("CAL0001", "Calibration Sample Employee", 25000);
+            string sampleJson = "{\"id\":\"CAL0001\",\"name\":\"Calibration Sample Employee\",\"type\":\"full-time\",\"salary\":25000}";
+            string sampleAudit = "R 1 1700000000 add F|CAL0001|25000|Calibration Sample Employee";
+            volatile double sink = 0;
+            map<string, double> measured;
+            measured["payroll"] = timePerIteration(256, [&](size_t) {
+                string record;
+                ostringstream out;
+                sample.writeRecord(out);
+                record = out.str();
+                sink = sink + static_cast<double>(fnv1aHash(record)) + 2 * sample.calculateSalary();
+            });
+            measured["snapshot"] = timePerIteration(256, [&](size_t) {
+                ostringstream out;
+                sample.writeRecord(out);
+                sink = sink + sha256(out.str()).size();
+            });
+            measured["report"] = timePerIteration(256, [&](size_t) {
+                ostringstream out;
+                sample.displayPayrollReport(out);
+                sink = sink + out.tellp();
+            });
+            measured["sweep"] = timePerIteration(4096, [&](size_t) {
+                sink = sink + sample.calculateSalary();
+            });
+            measured["duplicates"] = timePerIteration(256, [&](size_t) {
+                sink = sink + nameSignature(sample.getName()).size();
+            });
+            measured["import"] = timePerIteration(256, [&](size_t) {
+                string error;
+                delete parseNdjsonRecord(sampleJson, error);
+            });
+            measured["audit"] = timePerIteration(256, [&](size_t) {
+                sink = sink + sha256(sampleAudit).size();
+            });
+            
+            lock_guard<mutex> guard(lock);
+            threadStartSeconds = startSeconds;
+            for (const auto& entry : measured) {
+                itemSeconds[entry.first] = entry.second;
+            }
+        }
+        
+        // Chooses threads and chunk size for a sweep of items, each weighing the given number of cost units
+        Policy choose(const string& kind, size_t items, double weight = 1) const {
+            double perItem, startSeconds;
+            {
+                lock_guard<mutex> guard(lock);
+                auto cost = itemSeconds.find(kind);
+                perItem = (cost != itemSeconds.end() ? cost->second : DEFAULT_ITEM_SECONDS) * weight;
+                startSeconds = threadStartSeconds;
+            }
+            perItem = max(perItem, 1e-9);
+            
+            double work = items * perItem;
+            size_t threads = static_cast<size_t>(work / (startSeconds * THREAD_PAYOFF));
+            threads = max<size_t>(1, min(hardwareThreads, threads));
+            
+            size_t chunkSize = max<size_t>(1, static_cast<size_t>(MIN_CHUNK_SECONDS / perItem));
+            if (threads > 1) {
+                size_t balanced = (items + threads * CHUNKS_PER_THREAD - 1) / (threads * CHUNKS_PER_THREAD);
+                chunkSize = max<size_t>(1, min(chunkSize, balanced));
+            }
+            return Policy{threads, chunkSize};
+        }
+        
+        // Folds the measured time of a completed sweep into the cost estimate for its kind
+        void recordCost(const string& kind, size_t items, size_t threads, double seconds, double weight = 1) {
+            if (items == 0 || weight <= 0) {
+                return;
+            }
+            lock_guard<mutex> guard(lock);
+            double busy = max(0.0, seconds * threads - threadStartSeconds * (threads - 1));
+            double perItem = busy / (items * weight);
+            auto cost = itemSeconds.find(kind);
+            itemSeconds[kind] = cost == itemSeconds.end() ? perItem : (cost->second + perItem) / 2;
+        }
+        
+        // Runs body over [begin, end) chunks of items under the chosen policy. The body returns false to
+        // stop early; the first exception from any chunk is rethrown. Returns false if stopped early.
+        bool parallelFor(const string& kind, size_t items, const function<bool(size_t, size_t)>& body, double weight = 1) {
+            Policy policy = choose(kind, items, weight);
+            atomic<size_t> next(0);
+            atomic<bool> stopped(false);
+            mutex failureLock;
+            exception_ptr failure;
+            
+            auto worker = [&]() {
+                while (!stopped) {
+                    size_t begin = next.fetch_add(policy.chunkSize);
+                    if (begin >= items) {
+                        return;
+                    }
+                    try {
+                        if (!body(begin, min(items, begin + policy.chunkSize))) {
+                            stopped = true;
+                        }
+                    } catch (...) {
+                        lock_guard<mutex> guard(failureLock);
+                        if (!failure) {
+                            failure = current_exception();
+                        }
+                        stopped = true;
+                    }
+                }
+            };
+            
+            auto start = chrono::steady_clock::now();
+            vector<thread> threads;
+            for (size_t i = 1; i < policy.threads; ++i) {
+                threads.emplace_back(worker);
+            }
+            worker(); // The calling thread works too
+            for (auto& t : threads) {
+                t.join();
+            }
+            if (failure) {
+                rethrow_exception(failure);
+            }
+            if (stopped) {
+                return false;
+            }
+            recordCost(kind, items, policy.threads,
+                       chrono::duration<double>(chrono::steady_clock::now() - start).count(), weight);
+            return true;
+        }
+};
+
+// Shared executor for the parallel sweeps
+AdaptiveExecutor adaptiveExecutor;
+
+// Always-on ring buffer of the most recent operations (type, subject such as an employee ID,
+// duration), plus a log of operations slower than a threshold. Dumped on a signal or crash.
+class FlightRecorder {
+    private:
+        struct Entry {
+            const char* operation; // Points to a string literal
+            char subject[32];
+            double startSeconds;
+            double durationSeconds;
+        };
+        
+        static const size_t CAPACITY = 256;
+        Entry entries[CAPACITY] = {};
+        atomic<uint64_t> nextEntry{0};
+        chrono::steady_clock::time_point processStart = chrono::steady_clock::now();
+        
+        double slowThresholdSeconds = 0.1;
+#ifndef PAYROLL_LIBRARY
+        string slowLogPath = "payroll_slow_ops.log";
+#else
+        string slowLogPath; // A host application's working directory is not ours to write to
+#endif
+        mutex slowLogLock;
+        
+    public:
+        // Seconds since the recorder was created
+        double now() const {
+            return chrono::duration<double>(chrono::steady_clock::now() - processStart).count();
+        }
+        
+        void setSlowThreshold(double seconds) {
+            slowThresholdSeconds = seconds;
+        }
+        
+        // Records a finished operation; slow ones are also appended to the slow-operation log
+        void record(const char* operation, string_view subject, double startSeconds, double durationSeconds) {
+            Entry& entry = entries[nextEntry.fetch_add(1, memory_order_relaxed) % CAPACITY];
+            entry.operation = operation;
+            size_t length = min(subject.size(), sizeof(entry.subject) - 1);
+            memcpy(entry.subject, subject.data(), length);
+            entry.subject[length] = '\0';
+            entry.startSeconds = startSeconds;
+            entry.durationSeconds = durationSeconds;
+            
+            if (!slowLogPath.empty() && durationSeconds >= slowThresholdSeconds) {
+                lock_guard<mutex> guard(slowLogLock);
+                ofstream log(slowLogPath, ios::app);
+                log << fixed << setprecision(3) << "t+" << startSeconds << "s " << operation
+                    << (subject.empty() ? "" : " ") << subject << " took " << durationSeconds * 1000 << " ms" << endl;
+            }
+        }
+        
+        // Writes the recorded operations, oldest first, to a file descriptor. Formats into a stack
+        // buffer and writes with write(2) only, so it is safe to call from a signal handler.
+        void dump(int fd) const {
+            uint64_t end = nextEntry.load(memory_order_relaxed);
+            uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+            SignalSafeLine line;
+            line.append("--- flight recorder: last ");
+            line.append(end - begin);
+            line.append(" operation(s) ---\n");
+            line.writeTo(fd);
+            for (uint64_t i = begin; i < end; ++i) {
+                const Entry& entry = entries[i % CAPACITY];
+                if (entry.operation == nullptr) {
+                    continue;
+                }
+                line = SignalSafeLine();
+                line.append("t+");
+                line.appendFixed3(entry.startSeconds);
+                line.append("s ");
+                line.append(entry.operation);
+                line.append(" ");
+                line.append(entry.subject);
+                line.append(" ");
+                line.appendFixed3(entry.durationSeconds * 1000);
+                line.append(" ms\n");
+                line.writeTo(fd);
+            }
+        }
+        
+    private:
+        // Helper class to format one dump line without stdio or allocation
+        struct SignalSafeLine {
+            char text[160];
+            size_t length = 0;
+            
+            void append(const char* value) {
+                while (*value != '\0' && length < sizeof(text)) {
+                    text[length++] = *value++;
+                }
+            }
+            
+            void append(uint64_t value) {
+                char digits[20];
+                size_t count = 0;
+                do {
+                    digits[count++] = static_cast<char>('0' + value % 10);
+                    value /= 10;
+                } while (value > 0);
+                while (count > 0 && length < sizeof(text)) {
+                    text[length++] = digits[--count];
+                }
+            }
+            
+            // Appends a non-negative value with three decimals, as "%.3f" would
+            void appendFixed3(double value) {
+                uint64_t thousandths = value > 0 && value < 1e15 ? static_cast<uint64_t>(value * 1000 + 0.5) : 0;
+                append(thousandths / 1000);
+                char fraction[5] = {'.', static_cast<char>('0' + thousandths / 100 % 10),
+                                    static_cast<char>('0' + thousandths / 10 % 10),
+                                    static_cast<char>('0' + thousandths % 10), '\0'};
+                append(fraction);
+            }
+            
+            void writeTo(int fd) const {
+#ifdef _WIN32
+                _write(fd, text, static_cast<unsigned>(length));
+#else
+                if (::write(fd, text, length) < 0) {
+                    return;
+                }
+#endif
+            }
+        };
+};
+
+FlightRecorder flightRecorder;
+
+// Times an operation for the flight recorder from construction until the end of the scope
+class OperationTimer {
+    private:
+        const char* operation;
+        char subject[32];
+        size_t subjectLength;
+        double start;
+        
+    public:
+        // The subject is copied (truncated) into a fixed buffer, so timing never allocates
+        OperationTimer(const char* op, string_view subj = {})
+            : operation(op), subjectLength(min(subj.size(), sizeof(subject))), start(flightRecorder.now()) {
+            memcpy(subject, subj.data(), subjectLength);
+        }
+        
+        // Times an operation over a count of items, e.g. "1000 employee(s)"
+        OperationTimer(const char* op, size_t count, const char* unit)
+            : operation(op), subjectLength(0), start(flightRecorder.now()) {
+            char* end = to_chars(subject, subject + sizeof(subject), count).ptr;
+            char* limit = subject + sizeof(subject);
+            if (end < limit) {
+                *end++ = ' ';
+            }
+            while (end < limit && *unit != '\0') {
+                *end++ = *unit++;
+            }
+            subjectLength = static_cast<size_t>(end - subject);
+        }
+        
+        ~OperationTimer() {
+            flightRecorder.record(operation, string_view(subject, subjectLength), start, flightRecorder.now() - start);
+        }
+};
+
+// Cooperative cancellation flag, checked by long operations between chunks. Setting it is
+// lock-free, so it may be done from a signal handler.
+class CancellationToken {
+    private:
+        atomic<bool> cancelled{false};
+        
+    public:
+        void cancel() {
+            cancelled.store(true);
+        }
+        
+        void reset() {
+            cancelled.store(false);
+        }
+        
+        bool isCancelled() const {
+            return cancelled.load(memory_order_relaxed);
+        }
+};
+
+// Snapshot of a long operation's progress
+struct ProgressReport {
+    const char* operation;
+    size_t recordsDone;
+    size_t recordsTotal;
+    double elapsedSeconds;
+    bool finished;
+    
+    double recordsPerSecond() const {
+        return elapsedSeconds > 0 ? recordsDone / elapsedSeconds : 0;
+    }
+    
+    // Estimated seconds remaining at the current throughput
+    double etaSeconds() const {
+        double rate = recordsPerSecond();
+        return rate > 0 && recordsTotal > recordsDone ? (recordsTotal - recordsDone) / rate : 0;
+    }
+};
+
+using ProgressCallback = function<void(const ProgressReport&)>;
+
+// Tracks one long operation: counts processed records (from any thread), reports to the callback
+// at most every REPORT_INTERVAL seconds, and tells the operation whether it has been cancelled.
+// Operations call advance() once per chunk, so the overhead is negligible.
+class OperationProgress {
+    private:
+        static constexpr double REPORT_INTERVAL = 0.25;
+        
+        const char* operation;
+        size_t total;
+        const ProgressCallback& callback;
+        const CancellationToken* token;
+        atomic<size_t> done{0};
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        double lastReport = 0;
+        bool reported = false;
+        bool finished = false;
+        mutex reportLock;
+        
+        // Helper function to send a report to the callback
+        void report(bool final) {
+            double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            lastReport = elapsed;
+            reported = true;
+            callback(ProgressReport{operation, done.load(), total, elapsed, final});
+        }
+        
+    public:
+        OperationProgress(const char* op, size_t totalRecords, const ProgressCallback& cb, const CancellationToken* tok)
+            : operation(op), total(totalRecords), callback(cb), token(tok) {}
+        
+        ~OperationProgress() {
+            finish();
+        }
+        
+        // Sends the final report (only if progress was shown, so quick operations stay silent)
+        void finish() {
+            lock_guard<mutex> guard(reportLock);
+            if (reported && !finished) {
+                report(true);
+            }
+            finished = true;
+        }
+        
+        // Records processed records; returns false if the operation should stop
+        bool advance(size_t records) {
+            done += records;
+            if (callback) {
+                unique_lock<mutex> guard(reportLock, try_to_lock);
+                if (guard.owns_lock() && !finished &&
+                    chrono::duration<double>(chrono::steady_clock::now() - start).count() - lastReport >= REPORT_INTERVAL) {
+                    report(false);
+                }
+            }
+            return !isCancelled();
+        }
+        
+        bool isCancelled() const {
+            return token != nullptr && token->isCancelled();
+        }
+};
+
+// Signal handler that dumps the flight recorder; crashes then continue to the default action
+void dumpFlightRecorder(int signalNumber) {
+    flightRecorder.dump(STDERR_FILENO);
+#ifdef SIGUSR1
+    if (signalNumber == SIGUSR1) {
+        return;
+    }
+#endif
+    signal(signalNumber, SIG_DFL);
+    raise(signalNumber);
+}
+
+// Tamper-evident audit log. Each event is appended as a record line; records are sealed in
+// batches whose Merkle root is hash-chained to the previous batch, so editing, dropping or
+// reordering any sealed record breaks verification. File format:
+//   R <sequence> <unix time> <event>
+//   B <batch> <first sequence> <record count> <merkle root> <chain hash>
+class AuditLog {
+    private:
+        static const size_t BATCH_SIZE = 1024;
+        
+        string path;
+        ofstream out;
+        vector<string> pendingLeaves; // Hashes of records not yet sealed into a batch
+        unsigned long long nextSequence = 1;
+        unsigned long long nextBatch = 1;
+        unsigned long long batchFirstSequence = 1;
+        string chainHash = string(32, '\0');
+        
+        // Helper function to parse a batch line: B <batch> <first> <count> <root> <chain>
+        static bool parseBatchLine(const string& line, unsigned long long& batch, unsigned long long& first,
+                                   size_t& count, string& root, string& chain) {
+            istringstream fields(line.substr(1));
+            string rootHex, chainHex;
+            return (fields >> batch >> first >> count >> rootHex >> chainHex) &&
+                   parseHex(rootHex, root) && parseHex(chainHex, chain) &&
+                   root.size() == 32 && chain.size() == 32;
+        }
+        
+        // Helper function to read the sequence number of a record line
+        static bool parseRecordSequence(const string& line, unsigned long long& sequence) {
+            istringstream fields(line.substr(1));
+            return static_cast<bool>(fields >> sequence);
+        }
+        
+        // Helper function to read the head file kept beside the log: H <batches> <chain>. It anchors
+        // the log's length, so removing whole trailing batches no longer verifies.
+        static bool readHead(const string& logPath, unsigned long long& batches, string& chain) {
+            ifstream in(logPath + ".head");
+            string tag, chainHex;
+            return (in >> tag >> batches >> chainHex) && tag == "H" && parseHex(chainHex, chain) && chain.size() == 32;
+        }
+        
+        // Helper function to record the sealed batch count and chain hash in the head file
+        bool writeHead() const {
+            return writeFileAtomically(path + ".head", "H " + to_string(nextBatch - 1) + " " + bytesToHex(chainHash) + "\n");
+        }
+        
+    public:
+        ~AuditLog() {
+            seal();
+        }
+        
+        // Opens (or creates) the log, recovering the chain state and any unsealed records. A torn
+        // last line left by a crash is cut off; a log shorter than its head file is refused.
+        bool open(const string& logPath) {
+            path = logPath;
+            unsigned long long headBatches = 0;
+            string headChain;
+            bool hasHead = readHead(path, headBatches, headChain);
+            bool headMatched = !hasHead;
+            
+            ifstream existing(path, ios::binary);
+            string line;
+            uintmax_t completeBytes = 0; // Up to the end of the last newline-terminated line
+            while (getline(existing, line)) {
+                if (existing.eof()) {
+                    break; // No newline: torn by a crash mid-write
+                }
+                completeBytes += line.size() + 1;
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                unsigned long long batch, first, sequence;
+                size_t count;
+                string root, chain;
+                if (line.compare(0, 2, "R ") == 0 && parseRecordSequence(line, sequence)) {
+                    if (pendingLeaves.empty()) {
+                        batchFirstSequence = sequence;
+                    }
+                    pendingLeaves.push_back(sha256(line));
+                    nextSequence = sequence + 1;
+                } else if (line.compare(0, 2, "B ") == 0 && parseBatchLine(line, batch, first, count, root, chain)) {
+                    pendingLeaves.clear();
+                    chainHash = chain;
+                    nextBatch = batch + 1;
+                    batchFirstSequence = nextSequence;
+                    if (hasHead && batch == headBatches) {
+                        headMatched = chain == headChain;
+                    }
+                }
+            }
+            existing.close();
+            if (!headMatched) {
+                return false;
+            }
+            
+            error_code ec;
+            if (filesystem::exists(path, ec) && filesystem::file_size(path, ec) > completeBytes) {
+                filesystem::resize_file(path, completeBytes, ec);
+                if (ec) {
+                    return false;
+                }
+            }
+            // A crash between sealing a batch and updating the head leaves the head one batch behind
+            if (nextBatch > 1 && (!hasHead || headBatches < nextBatch - 1) && !writeHead()) {
+                return false;
+            }
+            out.open(path, ios::app);
+            return static_cast<bool>(out);
+        }
+        
+        // Appends an event record (buffered until flush); a full batch is sealed immediately
+        void append(const string& event) {
+            if (!out.is_open()) {
+                return;
+            }
+            if (pendingLeaves.empty()) {
+                batchFirstSequence = nextSequence;
+            }
+            long long now = chrono::duration_cast<chrono::seconds>(
+                chrono::system_clock::now().time_since_epoch()).count();
+            string line = "R " + to_string(nextSequence++) + " " + to_string(now) + " " + event;
+            out << line << "\n";
+            pendingLeaves.push_back(sha256(line));
+            if (pendingLeaves.size() >= BATCH_SIZE) {
+                seal();
+            }
+        }
+        
+        // Writes buffered records to disk
+        void flush() {
+            if (out.is_open()) {
+                out.flush();
+            }
+        }
+        
+        // Seals the pending records into a batch chained to the previous one
+        void seal() {
+            if (!out.is_open() || pendingLeaves.empty()) {
+                return;
+            }
+            string root = merkleRoot(pendingLeaves);
+            chainHash = sha256(chainHash + root);
+            out << "B " << nextBatch++ << " " << batchFirstSequence << " " << pendingLeaves.size() << " "
+                << bytesToHex(root) << " " << bytesToHex(chainHash) << endl;
+            pendingLeaves.clear();
+            writeHead();
+        }
+        
+        // Verifies a log file: batch Merkle roots are recomputed in parallel, then the chain is
+        // checked in order. Prints the outcome and returns true if every sealed batch is intact.
+        static bool verify(const string& logPath) {
+            ifstream in(logPath);
+            if (!in) {
+                cout << "Audit log " << logPath << " not found." << endl;
+                return false;
+            }
+            
+            struct Batch {
+                vector<string> records;
+                string line;
+            };
+            vector<Batch> batches(1);
+            string line;
+            while (getline(in, line)) {
+                if (line.compare(0, 2, "B ") == 0) {
+                    batches.back().line = line;
+                    batches.emplace_back();
+                } else {
+                    batches.back().records.push_back(line);
+                }
+            }
+            size_t unsealed = batches.back().records.size();
+            batches.pop_back();
+            
+            // Recompute every batch root, concurrently when the log is large enough to pay off
+            vector<string> roots(batches.size());
+            size_t sealedRecords = 0;
+            for (const auto& batch : batches) {
+                sealedRecords += batch.records.size();
+            }
+            double recordsPerBatch = batches.empty() ? 1 : static_cast<double>(sealedRecords) / batches.size();
+            adaptiveExecutor.parallelFor("audit", batches.size(), [&batches, &roots](size_t begin, size_t end) {
+                for (size_t b = begin; b < end; ++b) {
+                    vector<string> leaves;
+                    leaves.reserve(batches[b].records.size());
+                    for (const auto& record : batches[b].records) {
+                        leaves.push_back(sha256(record));
+                    }
+                    roots[b] = merkleRoot(leaves);
+                }
+                return true;
+            }, recordsPerBatch);
+            
+            // Check each batch header and the hash chain in order
+            string chain(32, '\0');
+            unsigned long long expectedSequence = 1;
+            size_t records = 0;
+            for (size_t b = 0; b < batches.size(); ++b) {
+                unsigned long long batchNumber, first, sequence;
+                size_t count;
+                string root, recordedChain;
+                bool ok = parseBatchLine(batches[b].line, batchNumber, first, count, root, recordedChain) &&
+                          batchNumber == b + 1 && first == expectedSequence && count == batches[b].records.size() &&
+                          root == roots[b];
+                for (size_t r = 0; ok && r < batches[b].records.size(); ++r) {
+                    ok = parseRecordSequence(batches[b].records[r], sequence) && sequence == first + r;
+                }
+                chain = sha256(chain + roots[b]);
+                if (!ok || chain != recordedChain) {
+                    cout << "Audit log verification FAILED at batch " << (b + 1) << "." << endl;
+                    return false;
+                }
+                expectedSequence = first + count;
+                records += count;
+            }
+            
+            // The head file anchors how many batches there should be
+            unsigned long long headBatches = 0;
+            string headChain;
+            bool hasHead = readHead(logPath, headBatches, headChain);
+            if ((hasHead || !batches.empty()) && (!hasHead || headBatches != batches.size() || headChain != chain)) {
+                cout << "Audit log verification FAILED: " << (hasHead ? "the log does not end at the batch recorded in "
+                                                                      : "missing head file ")
+                     << logPath << ".head; sealed batches may have been removed." << endl;
+                return false;
+            }
+            
+            cout << "Audit log verified: " << records << " record(s) in " << batches.size() << " batch(es) intact." << endl;
+            if (unsealed > 0) {
+                cout << unsealed << " trailing record(s) are not sealed yet and cannot be verified." << endl;
+            }
+            return true;
+        }
+};
+
+// Settings for a Monte Carlo simulation of the payroll cost over the next few months. Each
+// month, part-time hours are drawn from a normal distribution around the employee's current
+// hours (with the part-time cohort's relative spread, truncated at zero) and contractual projects
+// from a Poisson distribution around the current count. Full-time salaries are fixed.
+struct SimulationSettings {
+    size_t trials = 10000;      // At most MAX_SIMULATION_TRIALS
+    uint64_t seed = 1;
+    size_t months = 3;          // One quarter
+    double hoursSpread = 0.2;   // Standard deviation of monthly part-time hours, relative to current hours
+};
+
+// Most trials a simulation accepts; every trial's cost is kept for the percentiles (8 bytes each)
+const size_t MAX_SIMULATION_TRIALS = 10000000;
+
+// Cost distribution produced by a simulation
+struct SimulationResult {
+    size_t trials = 0;
+    double currentCost = 0;                     // Cost if every month matched the current roster
+    double mean = 0;
+    vector<pair<double, double>> percentiles;   // Percentile, then cost
+};
+
+// Counter-based random number in (0, 1): a pure function of the seed and the draw's coordinates,
+// so a trial gets the same numbers whichever thread runs it and in whatever order
+double counterUniform(uint64_t seed, uint64_t trial, uint64_t stream) {
+    uint64_t bits = mixHash(mixHash(seed + 0x9e3779b97f4a7c15ULL * (trial + 1)) ^ (stream + 0x632be59bd9b4e019ULL));
+    return ((bits >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Standard normal draw (Box-Muller) from streams 2 * pair and 2 * pair + 1
+double counterNormal(uint64_t seed, uint64_t trial, uint64_t pair) {
+    const double TWO_PI = 6.283185307179586;
+    double u1 = counterUniform(seed, trial, 2 * pair), u2 = counterUniform(seed, trial, 2 * pair + 1);
+    return sqrt(-2 * log(u1)) * cos(TWO_PI * u2);
+}
+
+// Poisson draw with the given mean: inverse CDF for small means, a rounded normal approximation for large ones
+double counterPoisson(double mean, uint64_t seed, uint64_t trial, uint64_t pair) {
+    if (mean <= 0) {
+        return 0;
+    }
+    if (mean > 64) {
+        return max(0.0, round(mean + sqrt(mean) * counterNormal(seed, trial, pair)));
+    }
+    double u = counterUniform(seed, trial, 2 * pair);
+    double probability = exp(-mean), cumulative = probability;
+    int k = 0;
+    while (u > cumulative && probability > 0) {
+        ++k;
+        probability *= mean / k;
+        cumulative += probability;
+    }
+    return k;
+}
+
+// Next-period pay forecast built from stored pay history
+struct ForecastResult {
+    size_t periods = 0;         // Periods of history used
+    size_t employees = 0;       // Employees in the latest period, the ones forecast
+    double lastTotal = 0;       // Total pay in the latest period
+    double trendTotal = 0;      // Sum of per-employee least-squares linear trend forecasts
+    double smoothedTotal = 0;   // Sum of per-employee simple exponential smoothing forecasts
+};
+
+// Owns the employees of one roster generation (from one roster replacement to the next) after the
+// roster has moved past it, so they live on until the last snapshot reading them is released
+struct EmployeeGeneration {
+    vector<Employee*> retired;
+    
+    ~EmployeeGeneration() {
+        for (auto emp : retired) {
+            delete emp;
+        }
+    }
+};
+
+// Read-only view of the roster at one version, safe to use from any thread while the roster keeps
+// changing; readers never see a half-applied commit. Versions share their employee slots in fixed
+// blocks: within a generation employees are only appended, and a commit fills slots past the end
+// every older version reads, so publishing a version copies no employees.
+class RosterSnapshot {
+    public:
+        static const size_t BLOCK_SIZE = 1024;
+        using Block = array<const Employee*, BLOCK_SIZE>;
+        
+    private:
+        friend class PayrollSystem;
+        shared_ptr<const EmployeeGeneration> generation;
+        shared_ptr<const vector<shared_ptr<Block>>> blocks;
+        size_t count = 0;
+        unsigned long long version = 0;
+        
+    public:
+        size_t size() const {
+            return count;
+        }
+        
+        // Roster version this snapshot shows
+        unsigned long long getVersion() const {
+            return version;
+        }
+        
+        const Employee& operator[](size_t index) const {
+            return *(*(*blocks)[index / BLOCK_SIZE])[index % BLOCK_SIZE];
+        }
+        
+        double calculateTotalPayroll() const {
+            double total = 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                total += (*this)[i].calculateSalary();
+            }
+            return total;
+        }
+};
+
+// PayrollSystem class to manage employees
+class PayrollSystem {
+    private:
+        vector<Employee*> employees;
+        
+        // ID index (employee ID -> position in the roster) and name index (lowercased name ->
+        // positions). After a roster swap both are rebuilt in the background; until they are
+        // adopted, lookups fall back to scanning the roster.
+        mutable unordered_map<string, size_t> idIndex;
+        mutable unordered_map<string, vector<size_t>> nameIndex;
+        
+        // Indexes built off the main thread over the first pendingIndexCount employees
+        struct RosterIndexes {
+            unordered_map<string, size_t> byId;
+            unordered_map<string, vector<size_t>> byName;
+            chrono::steady_clock::time_point finished;
+        };
+        mutable future<RosterIndexes> pendingIndexes;
+        mutable size_t pendingIndexCount = 0;
+        
+        // Adopting the background build happens inside const lookups, so it is serialized by a
+        // lock; the flag lets lookups skip the lock once the indexes are in place
+        mutable mutex indexLock;
+        mutable atomic<bool> indexBuildPending{false};
+        
+        // Timing of the latest background build, reported once at the next menu
+        chrono::steady_clock::time_point indexTimingStart;
+        mutable double indexReadySeconds = -1;
+        
+        // Roster version, bumped on every mutation so cached output can be reused
+        unsigned long long rosterVersion = 1;
+        
+        // Current employee generation, the block table of published versions, how many employees
+        // it holds, and the latest published version (read by other threads through atomic_load)
+        shared_ptr<EmployeeGeneration> generation = make_shared<EmployeeGeneration>();
+        shared_ptr<vector<shared_ptr<RosterSnapshot::Block>>> publishedBlocks;
+        size_t publishedCount = 0;
+        shared_ptr<const RosterSnapshot> publishedRoster;
+        
+        // Tamper-evident record of every roster change
+        AuditLog auditLog;
+        
+        // Progress reporting and cancellation for long operations
+        ProgressCallback progressCallback;
+        const CancellationToken* cancellationToken = nullptr;
+        
+        // AES-256 key for encrypting snapshot chunks at rest (empty means snapshots are stored in plain text)
+        string snapshotKey;
+        
+        // Memory budget for employee records (possibly shared with other rosters) and this roster's share
+        shared_ptr<MemoryBudget> memoryBudget = make_shared<MemoryBudget>();
+        size_t memoryHeld = 0; // Bytes this roster holds in the budget (employees and staged batches)
+        
+        // Number of employees rendered together in one report chunk
+        static const size_t REPORT_CHUNK_SIZE = 1024;
+        
+        // Snapshot chunks encoded or decoded together in parallel before being written or staged in order
+        static const size_t SNAPSHOT_WINDOW = 64;
+        
+        // Rendered report text per employee-range chunk, with dirty flags for chunks needing re-rendering
+        // (char rather than bool so chunks can be cleared concurrently)
+        mutable vector<string> reportChunks;
+        mutable vector<char> reportChunkDirty;
+        
+        // Roster version the chunk texts were last brought up to date for
+        mutable unsigned long long renderedReportVersion = 0;
+        
+        // Helper function to flag the report chunk containing an employee for re-rendering
+        void markEmployeeDirty(size_t index) {
+            size_t chunk = index / REPORT_CHUNK_SIZE;
+            if (chunk >= reportChunkDirty.size()) {
+                reportChunks.resize(chunk + 1);
+                reportChunkDirty.resize(chunk + 1, true);
+            }
+            reportChunkDirty[chunk] = true;
+        }
+        
+        // Helper function to build the name index key (names match case-insensitively)
+        static string nameKey(const string& name) {
+            string key = name;
+            transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+            return key;
+        }
+        
+        // Helper function to add one roster position to the indexes
+        void indexEmployee(size_t index) const {
+            idIndex[employees[index]->getId()] = index;
+            nameIndex[nameKey(employees[index]->getName())].push_back(index);
+        }
+        
+        // Helper function to report whether the indexes are usable, adopting a finished background
+        // build (and indexing employees added since it started) when there is one
+        bool indexesReady() const {
+            if (!indexBuildPending.load(memory_order_acquire)) {
+                return true;
+            }
+            lock_guard<mutex> guard(indexLock);
+            if (!pendingIndexes.valid()) {
+                return true;
+            }
+            if (pendingIndexes.wait_for(chrono::seconds(0)) != future_status::ready) {
+                return false;
+            }
+            adoptIndexes();
+            return true;
+        }
+        
+        // Helper function to wait for a background index build to finish
+        void waitForIndexes() const {
+            if (!indexBuildPending.load(memory_order_acquire)) {
+                return;
+            }
+            lock_guard<mutex> guard(indexLock);
+            if (pendingIndexes.valid()) {
+                adoptIndexes();
+            }
+        }
+        
+        // Helper function to swap in the finished background build; indexLock must be held
+        void adoptIndexes() const {
+            RosterIndexes built = pendingIndexes.get();
+            idIndex.swap(built.byId);
+            nameIndex.swap(built.byName);
+            for (size_t i = pendingIndexCount; i < employees.size(); ++i) {
+                indexEmployee(i);
+            }
+            indexReadySeconds = chrono::duration<double>(built.finished - indexTimingStart).count();
+            indexBuildPending.store(false, memory_order_release);
+        }
+        
+        // Helper function to rebuild the indexes in the background over the current roster. The
+        // builder works on its own copy of the employee pointers; employees are immutable and are
+        // only deleted after waitForIndexes().
+        void startIndexBuild() {
+            lock_guard<mutex> guard(indexLock);
+            indexTimingStart = chrono::steady_clock::now();
+            idIndex.clear();
+            nameIndex.clear();
+            pendingIndexCount = employees.size();
+            vector<const Employee*> roster(employees.begin(), employees.end());
+            pendingIndexes = async(launch::async, [roster = move(roster)]() {
+                OperationTimer timer("build indexes", roster.size(), "employee(s)");
+                RosterIndexes built;
+                built.byId.reserve(roster.size());
+                for (size_t i = 0; i < roster.size(); ++i) {
+                    built.byId[roster[i]->getId()] = i;
+                    built.byName[nameKey(roster[i]->getName())].push_back(i);
+                }
+                built.finished = chrono::steady_clock::now();
+                return built;
+            });
+            indexBuildPending.store(true, memory_order_release);
+        }
+        
+        // Helper function to format an employee's full record (ID, name and pay) for the audit log
+        static string auditRecord(const Employee* emp) {
+            ostringstream record;
+            record.precision(numeric_limits<double>::max_digits10);
+            emp->writeRecord(record);
+            string event = record.str();
+            event.pop_back(); // Drop the newline
+            return event;
+        }
+        
+        // Helper function to append an employee without bumping the roster version
+        void appendEmployee(Employee* emp) {
+            auditLog.append("add " + auditRecord(emp));
+            
+            bool indexed = indexesReady(); // Adopting a finished build first indexes everything before this employee
+            employees.push_back(emp);
+            if (indexed) {
+                indexEmployee(employees.size() - 1);
+            }
+            markEmployeeDirty(employees.size() - 1);
+        }
+        
+        // Helper function to add an employee and record the mutation. Memory is reserved with the
+        // finished record's real size (a long name may not fit); a refused employee is deleted.
+        bool addEmployee(Employee* emp) {
+            OperationTimer timer("add employee", emp->getId());
+            if (!reserveMemory(estimateEmployeeBytes(emp))) {
+                printMemoryBudgetReached(estimateEmployeeBytes(emp));
+                delete emp;
+                return false;
+            }
+            appendEmployee(emp);
+            auditLog.flush();
+            ++rosterVersion;
+            publishRoster();
+            return true;
+        }
+        
+        // Helper function to publish the roster as a new snapshot version. Existing blocks are shared
+        // with older versions; new employees go in slots none of them reads, and the block table is
+        // only copied when a block is added.
+        void publishRoster() {
+            if (!publishedBlocks) {
+                publishedBlocks = make_shared<vector<shared_ptr<RosterSnapshot::Block>>>();
+                publishedCount = 0;
+            }
+            size_t blocksNeeded = (employees.size() + RosterSnapshot::BLOCK_SIZE - 1) / RosterSnapshot::BLOCK_SIZE;
+            if (blocksNeeded > publishedBlocks->size()) {
+                auto table = make_shared<vector<shared_ptr<RosterSnapshot::Block>>>();
+                table->reserve(blocksNeeded);
+                *table = *publishedBlocks;
+                while (table->size() < blocksNeeded) {
+                    table->push_back(make_shared<RosterSnapshot::Block>());
+                }
+                publishedBlocks = table;
+            }
+            for (; publishedCount < employees.size(); ++publishedCount) {
+                (*(*publishedBlocks)[publishedCount / RosterSnapshot::BLOCK_SIZE])[publishedCount % RosterSnapshot::BLOCK_SIZE] =
+                    employees[publishedCount];
+            }
+            auto next = make_shared<RosterSnapshot>();
+            next->generation = generation;
+            next->blocks = publishedBlocks;
+            next->count = employees.size();
+            next->version = rosterVersion;
+            atomic_store(&publishedRoster, shared_ptr<const RosterSnapshot>(move(next)));
+        }
+        
+        // Helper function to bring the report chunk texts up to date, re-rendering only dirty chunks.
+        // The optional hook is told how many employees each chunk covered and returns false to stop
+        // early, in which case some chunks stay dirty and false is returned.
+        bool renderPayrollReport(const function<bool(size_t)>& onChunk = nullptr, bool allowParallel = true) const {
+            if (renderedReportVersion == rosterVersion) {
+                return true;
+            }
+            
+            // Re-render the dirty chunks; chunks are independent, so a large backlog is rendered in parallel
+            auto renderChunks = [this, &onChunk](size_t first, size_t last) {
+                for (size_t chunk = first; chunk < last; ++chunk) {
+                    size_t begin = chunk * REPORT_CHUNK_SIZE;
+                    size_t end = min(employees.size(), begin + REPORT_CHUNK_SIZE);
+                    if (onChunk && !onChunk(end - begin)) {
+                        return false;
+                    }
+                    if (reportChunkDirty[chunk]) {
+                        ostringstream out;
+                        for (size_t i = begin; i < end; ++i) {
+                            employees[i]->displayPayrollReport(out);
+                            out << endl;
+                        }
+                        reportChunks[chunk] = out.str();
+                        reportChunkDirty[chunk] = false;
+                    }
+                }
+                return true;
+            };
+            size_t dirtyChunks = count(reportChunkDirty.begin(), reportChunkDirty.end(), true);
+            double chunkWeight = reportChunks.empty() ? 0 : static_cast<double>(dirtyChunks) * REPORT_CHUNK_SIZE / reportChunks.size();
+            bool rendered = allowParallel
+                ? adaptiveExecutor.parallelFor("report", reportChunks.size(), renderChunks, chunkWeight)
+                : renderChunks(0, reportChunks.size());
+            if (!rendered) {
+                return false;
+            }
+            renderedReportVersion = rosterVersion;
+            return true;
+        }
+        
+        // Helper function to walk the rendered report in order: the header, then each chunk text.
+        // The report is never assembled into one string, so a change only costs its own chunk.
+        void forEachReportPart(const function<void(string_view)>& visit) const {
+            visit("------ Employee Payroll Report ------\n");
+            for (const auto& text : reportChunks) {
+                visit(text);
+            }
+        }
+        
+        // Helper function to swap in a whole new roster, e.g. after restoring a snapshot
+        void replaceRoster(vector<Employee*>& newEmployees) {
+            waitForIndexes(); // The builder may still be reading the old employees
+            size_t oldBytes = 0;
+            for (auto emp : employees) {
+                oldBytes += estimateEmployeeBytes(emp);
+            }
+            releaseMemory(oldBytes); // The new employees were reserved when staged
+            
+            // The old employees are deleted with their generation, once no snapshot reads them
+            generation->retired.swap(employees);
+            generation = make_shared<EmployeeGeneration>();
+            publishedBlocks.reset();
+            employees.swap(newEmployees);
+            newEmployees.clear();
+            startIndexBuild();
+            reportChunks.clear();
+            reportChunkDirty.clear();
+            if (!employees.empty()) {
+                markEmployeeDirty(employees.size() - 1);
+                fill(reportChunkDirty.begin(), reportChunkDirty.end(), true);
+            }
+            ++rosterVersion;
+            publishRoster();
+        }
+        
+        // Helper function to get the number of employee-range chunks in the roster
+        size_t chunkCount() const {
+            return (employees.size() + REPORT_CHUNK_SIZE - 1) / REPORT_CHUNK_SIZE;
+        }
+        
+        // Helper function to serialize one employee-range chunk: columnar with packed numeric
+        // columns, or snapshot record lines if a value cannot be packed exactly
+        string serializeChunk(size_t chunk) const {
+            size_t begin = chunk * REPORT_CHUNK_SIZE;
+            size_t count = min(employees.size(), begin + REPORT_CHUNK_SIZE) - begin;
+            string columnar;
+            if (encodeColumnarChunk(employees.data() + begin, count, columnar)) {
+                return columnar;
+            }
+            
+            ostringstream out;
+            out.precision(numeric_limits<double>::max_digits10);
+            size_t end = min(employees.size(), (chunk + 1) * REPORT_CHUNK_SIZE);
+            for (size_t i = chunk * REPORT_CHUNK_SIZE; i < end; ++i) {
+                employees[i]->writeRecord(out);
+            }
+            return out.str();
+        }
+        
+        // Outcome of reading one stored snapshot chunk
+        enum class ChunkStatus { Ok, Undecryptable, Corrupted, Malformed };
+        
+        // Helper function to read, decrypt, verify and decode one stored snapshot chunk into decoded
+        // (which the caller owns, also on failure); safe to run for several chunks at once
+        static ChunkStatus readSnapshotChunk(const filesystem::path& dir, const string& hash, size_t size,
+                                             const string& key, vector<Employee*>& decoded) {
+            string data;
+            ifstream chunkFile(dir / "chunks" / (hash + ".chunk"), ios::binary);
+            {
+                OperationTimer chunkTimer("read snapshot chunk", hash);
+                data.assign(istreambuf_iterator<char>(chunkFile), istreambuf_iterator<char>());
+            }
+            if (isEncryptedChunk(data)) {
+                string plain;
+                if (!decryptChunk(key, hash, data, plain)) {
+                    return ChunkStatus::Undecryptable;
+                }
+                data.swap(plain);
+            }
+            // Keyed (64-digit) names are checked with the key, plain (16-digit) names with FNV-1a
+            string expected = hash.size() == 64 ? (key.empty() ? string() : bytesToHex(hmacSha256(key, data)))
+                                                : toHex(fnv1aHash(data));
+            if (!chunkFile.is_open() || data.size() != size || expected != hash) {
+                return ChunkStatus::Corrupted;
+            }
+            
+            if (data.compare(0, COLUMNAR_CHUNK_MAGIC.size(), COLUMNAR_CHUNK_MAGIC) == 0) {
+                return decodeColumnarChunk(data, decoded) ? ChunkStatus::Ok : ChunkStatus::Malformed;
+            }
+            istringstream records(data);
+            string line;
+            while (getline(records, line)) {
+                Employee* emp = parseEmployeeRecord(line);
+                if (emp == nullptr) {
+                    return ChunkStatus::Malformed;
+                }
+                decoded.push_back(emp);
+            }
+            return ChunkStatus::Ok;
+        }
+        
+        // Helper function to read the sequence number of the latest snapshot (0 if none)
+        static unsigned long readLatestSnapshot(const filesystem::path& dir) {
+            ifstream latest(dir / "LATEST");
+            unsigned long sequence = 0;
+            if (!(latest >> sequence)) {
+                return 0;
+            }
+            return sequence;
+        }
+        
+        // Helper function to list the stored pay periods oldest first. Periods are named by pay date
+        // (period-YYYY-MM-DD.txt), so name order is date order.
+        static vector<filesystem::path> listPayPeriods(const filesystem::path& dir) {
+            vector<filesystem::path> periods;
+            error_code ec;
+            for (filesystem::directory_iterator entry(dir, ec), end; !ec && entry != end; entry.increment(ec)) {
+                string name = entry->path().filename().string();
+                if (name.size() <= 11 || name.compare(0, 7, "period-") != 0 || name.compare(name.size() - 4, 4, ".txt") != 0) {
+                    continue;
+                }
+                periods.push_back(entry->path());
+            }
+            sort(periods.begin(), periods.end());
+            return periods;
+        }
+        
+        // Helper function to visit every (ID, pay) record of a stored pay period
+        static bool forEachPayRecord(const filesystem::path& path, const function<void(string_view, double)>& visit) {
+            ifstream in(path, ios::binary);
+            if (!in) {
+                return false;
+            }
+            string buffer((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+            size_t start = 0;
+            while (start < buffer.size()) {
+                size_t end = buffer.find('\n', start);
+                if (end == string::npos) {
+                    end = buffer.size();
+                }
+                size_t space = buffer.find(' ', start);
+                double pay;
+                if (buffer[start] != '#' && space < end &&
+                    from_chars(buffer.data() + space + 1, buffer.data() + end, pay).ec == errc()) {
+                    visit(string_view(buffer).substr(start, space - start), pay);
+                }
+                start = end + 1;
+            }
+            return true;
+        }
+        
+        // Helper function to check if an ID already exists
+        bool isIdUnique(const string& id) const {
+            return findEmployee(id) == nullptr;
+        }
+        
+        // Helper function to reserve bytes in the memory budget; while the budget is full this waits
+        // for other rosters sharing it to release memory, and returns false if none can
+        bool reserveMemory(size_t bytes) {
+            if (!memoryBudget->reserve(bytes, memoryHeld == 0)) {
+                return false;
+            }
+            memoryHeld += bytes;
+            return true;
+        }
+        
+        // Helper function to return reserved bytes to the memory budget
+        void releaseMemory(size_t bytes) {
+            memoryHeld -= bytes;
+            memoryBudget->release(bytes, memoryHeld == 0);
+        }
+        
+        // Helper function to tell the user an employee was refused by the memory budget
+        void printMemoryBudgetReached(size_t extraBytes) const {
+            cout << "Memory budget reached (" << memoryBudget->getInUse() << " of " << memoryBudget->getLimit()
+                 << " bytes in use, " << extraBytes << " more needed). Cannot add the employee." << endl;
+        }
+        
+        // Helper function to refuse an employee that would exceed the memory budget; by default
+        // checks room for the smallest possible record, before any details are prompted for
+        bool checkMemoryBudget(size_t extraBytes = sizeof(ContractualEmployee) + sizeof(Employee*)) const {
+            if (memoryBudget->fits(extraBytes)) {
+                return true;
+            }
+            printMemoryBudgetReached(extraBytes);
+            return false;
+        }
+        
+        // Helper function to get employee ID with validation
+        string getEmployeeId() {
+            string id;
+            bool validInput = false;
+            
+            while (!validInput) {
+                cout << "Enter Employee ID: ";
+                id = readInputLine();
+                
+                if (id.empty()) {
+                    cout << "ID cannot be empty. Please try again." << endl;
+                } else if (!isValidID(id)) {
+                    cout << "Invalid ID format! ID must contain only alphanumeric characters: ID must contain only letters and numbers with no spaces or special characters." << endl;
+                } else if (!isIdUnique(id)) {
+                    cout << "Duplicate ID! Please enter a unique ID." << endl;
+                } else {
+                    validInput = true;
+                }
+            }
+            return id;
+        }
+        
+        // Helper function to get employee name
+        string getEmployeeName() {
+            string name;
+            bool validInput = false;
+            
+            while (!validInput) {
+                cout << "Enter Employee Name: ";
+                name = readInputLine();
+                
+                if (!name.empty()) {
+                    validInput = true;
+                } else {
+                    cout << "Name cannot be empty. Please try again." << endl;
+                }
+            }
+            return name;
+        }
+        
+        // Helper function to get valid decimal value (for salary and hours)
+        double getValidDecimalInput(const string& prompt) {
+            string input;
+            double value;
+            bool validInput = false;
+            
+            while (!validInput) {
+                cout << prompt;
+                input = readInputLine();
+                
+                if (isValidDecimal(input, value)) {
+                    if (value > 0) {
+                        validInput = true;
+                    } else {
+                        cout << "Value must be greater than zero. Please try again." << endl;
+                    }
+                } else {
+                    cout << "Invalid format. Please enter a valid number." << endl;
+                }
+            }
+            return value;
+        }
+        
+        // Helper function to get valid number of projects
+        int getValidNumericInput(const string& prompt) {
+            string input;
+            int value;
+            bool validInput = false;
+            
+            while (!validInput) {
+                cout << prompt;
+                input = readInputLine();
+                
+                if (isValidInteger(input, value)) {
+                    if (value >= 0) {
+                        validInput = true;
+                    } else {
+                        cout << "Value cannot be negative. Please try again." << endl;
+                    }
+                } else {
+                    cout << "Invalid input. Please enter a valid number." << endl;
+                }
+            }
+            return value;
+        }
+        
+    public:
+        // Why a change to the roster was refused
+        enum class Failure { None, DuplicateId, MemoryBudget };
+        
+        // Batch of employee changes applied atomically on commit. Staged employees are invisible
+        // to every reader of the roster until commit, which publishes them as one roster version.
+        class Transaction {
+            private:
+                PayrollSystem& system;
+                bool replacesRoster; // Commit swaps in the staged employees as the whole roster
+                vector<Employee*> staged;
+                unordered_set<string> stagedIds;
+                size_t stagedBytes = 0;
+                size_t reservedBytes = 0; // Held in the memory budget for this batch (staged or ahead)
+                string error;
+                Failure failure = Failure::None;
+                
+            public:
+                // Every staged ID is checked against the roster, so an append transaction waits
+                // for a background index build rather than scanning the roster per employee
+                Transaction(PayrollSystem& target, bool replace)
+                    : system(target), replacesRoster(replace) {
+                    if (!replacesRoster) {
+                        system.waitForIndexes();
+                    }
+                }
+                
+                Transaction(const Transaction&) = delete;
+                Transaction& operator=(const Transaction&) = delete;
+                
+                // Uncommitted changes are discarded
+                ~Transaction() {
+                    rollback();
+                }
+                
+                // Reserves memory for the whole batch before staging it, waiting until it fits, so
+                // loaders sharing a budget take turns rather than each holding part of what it
+                // needs. Returns false if it cannot be had; staging then reserves as it goes.
+                bool reserveAhead(size_t bytes) {
+                    if (bytes <= reservedBytes) {
+                        return true;
+                    }
+                    if (!system.reserveMemory(bytes - reservedBytes)) {
+                        return false;
+                    }
+                    reservedBytes = bytes;
+                    return true;
+                }
+                
+                // Stages an employee (taking ownership); returns false and discards it if the
+                // ID is duplicated or the batch no longer fits the memory budget. A failed stage
+                // fails the transaction: later stages and the commit are refused.
+                bool stage(Employee* emp) {
+                    if (failure != Failure::None) {
+                        delete emp;
+                        return false;
+                    }
+                    if (stagedIds.count(emp->getId()) != 0 || (!replacesRoster && !system.isIdUnique(emp->getId()))) {
+                        error = "Duplicate ID: " + emp->getId();
+                        failure = Failure::DuplicateId;
+                        delete emp;
+                        return false;
+                    }
+                    // Until commit the current roster stays in memory too, so both count against the
+                    // budget. Staging waits here while other rosters sharing the budget hold it full.
+                    size_t bytes = estimateEmployeeBytes(emp);
+                    if (stagedBytes + bytes > reservedBytes && !system.reserveMemory(stagedBytes + bytes - reservedBytes)) {
+                        error = "Batch exceeds the memory budget (" + to_string(system.memoryBudget->getLimit()) + " bytes, " +
+                                to_string(system.memoryBudget->getInUse()) + " in use; the batch needs " +
+                                to_string(stagedBytes + bytes) + " so far)";
+                        failure = Failure::MemoryBudget;
+                        delete emp;
+                        return false;
+                    }
+                    stagedIds.insert(emp->getId());
+                    stagedBytes += bytes;
+                    reservedBytes = max(reservedBytes, stagedBytes);
+                    staged.push_back(emp);
+                    return true;
+                }
+                
+                // Publishes every staged employee as a single new roster version. Returns false,
+                // leaving the roster unchanged, if a stage failed or a staged ID has since been
+                // added to the roster.
+                bool commit() {
+                    if (failure != Failure::None) {
+                        return false;
+                    }
+                    if (!replacesRoster) {
+                        for (auto emp : staged) {
+                            if (!system.isIdUnique(emp->getId())) {
+                                error = "Duplicate ID: " + emp->getId();
+                                failure = Failure::DuplicateId;
+                                return false;
+                            }
+                        }
+                    }
+                    OperationTimer timer("commit transaction", staged.size(), "employee(s)");
+                    if (replacesRoster) {
+                        // Every incoming employee is recorded, so the log shows exactly what the roster became
+                        system.auditLog.append("replace roster " + to_string(staged.size()) + " employee(s)");
+                        for (auto emp : staged) {
+                            system.auditLog.append("load " + auditRecord(emp));
+                        }
+                        system.auditLog.flush();
+                        system.replaceRoster(staged);
+                    } else if (!staged.empty()) {
+                        system.employees.reserve(system.employees.size() + staged.size());
+                        if (system.indexesReady()) {
+                            system.idIndex.reserve(system.employees.size() + staged.size());
+                        }
+                        for (auto emp : staged) {
+                            system.appendEmployee(emp);
+                        }
+                        system.auditLog.flush();
+                        ++system.rosterVersion;
+                        system.publishRoster();
+                    }
+                    system.releaseMemory(reservedBytes - stagedBytes); // The employees keep what they use
+                    staged.clear();
+                    stagedIds.clear();
+                    stagedBytes = 0;
+                    reservedBytes = 0;
+                    return true;
+                }
+                
+                // Discards every staged employee
+                void rollback() {
+                    for (auto emp : staged) {
+                        delete emp;
+                    }
+                    system.releaseMemory(reservedBytes);
+                    staged.clear();
+                    stagedIds.clear();
+                    stagedBytes = 0;
+                    reservedBytes = 0;
+                }
+                
+                size_t size() const {
+                    return staged.size();
+                }
+                
+                const string& getError() const {
+                    return error;
+                }
+                
+                Failure getFailure() const {
+                    return failure;
+                }
+        };
+        
+        // Opens the audit log that records every roster change
+        bool openAuditLog(const string& path) {
+            return auditLog.open(path);
+        }
+        
+        // Seals any pending audit records so they can be verified
+        void flushAuditLog() {
+            auditLog.seal();
+        }
+        
+        // Sets the callback receiving progress of long operations
+        void setProgressCallback(const ProgressCallback& callback) {
+            progressCallback = callback;
+        }
+        
+        // Sets the token long operations check (between chunks) to see if they should stop
+        void setCancellationToken(const CancellationToken* token) {
+            cancellationToken = token;
+        }
+        
+        // Sets the 32-byte AES-256 key used to encrypt new snapshot chunks (empty disables encryption)
+        void setSnapshotKey(const string& key) {
+            snapshotKey = key;
+        }
+        
+        // Sets the memory budget for employee records in bytes (0 means unlimited)
+        void setMemoryBudget(size_t bytes) {
+            memoryBudget->setLimit(bytes);
+        }
+        
+        // Charges this roster to a memory budget shared with other rosters; call it while the roster is empty
+        void shareMemoryBudget(const shared_ptr<MemoryBudget>& budget) {
+            memoryBudget = budget;
+        }
+        
+        // Destructor to free memory
+        ~PayrollSystem() {
+            waitForIndexes();
+            generation->retired.swap(employees); // Deleted now, or when the last snapshot is released
+            releaseMemory(memoryHeld);
+        }
+        
+        // Returns the latest committed version of the roster. Safe to call from any thread, also while
+        // a commit is in progress; the snapshot stays valid and unchanged for as long as it is held,
+        // and versions (and replaced employees) no snapshot holds are freed.
+        shared_ptr<const RosterSnapshot> takeSnapshot() const {
+            shared_ptr<const RosterSnapshot> latest = atomic_load(&publishedRoster);
+            return latest ? latest : make_shared<const RosterSnapshot>();
+        }
+        
+        // Function to add a full-time employee
+        void addFullTimeEmployee() {
+            if (!checkMemoryBudget()) {
+                return;
+            }
+            string id = getEmployeeId();
+            string name = getEmployeeName();
             double salary = getValidDecimalInput("Enter Monthly Salary: $");
             
-            employees.push_back(new FullTimeEmployee(id, name, salary));
-            cout << "Full-time employee added successfully!" << endl;
+            if (!addEmployee(new FullTimeEmployee(id, name, salary))) {
+                return;
+            }
+            cout << "Full-time employee added successfully!" << endl;
+        }
+        
+        // Function to add a part-time employee
+        void addPartTimeEmployee() {
+            if (!checkMemoryBudget()) {
+                return;
+            }
+            string id = getEmployeeId();
+            string name = getEmployeeName();
+            double hourlyWage = getValidDecimalInput("Enter Hourly Wage: $");
+            double hoursWorked = getValidDecimalInput("Enter Number of Hours Worked: ");
+            
+            if (!addEmployee(new PartTimeEmployee(id, name, hourlyWage, hoursWorked))) {
+                return;
+            }
+            cout << "Part-time employee added successfully!" << endl;
+        }
+        
+        // Function to add a contractual employee
+        void addContractualEmployee() {
+            if (!checkMemoryBudget()) {
+                return;
+            }
+            string id = getEmployeeId();
+            string name = getEmployeeName();
+            double paymentPerProject = getValidDecimalInput("Enter Payment Per Project: $");
+            int projectsCompleted = getValidNumericInput("Enter Number of Projects Completed: ");
+            
+            if (!addEmployee(new ContractualEmployee(id, name, paymentPerProject, projectsCompleted))) {
+                return;
+            }
+            cout << "Contractual employee added successfully!" << endl;
+        }
+        
+        // Reports a background index build that finished since the last call (shown at the menu so
+        // it never interrupts a prompt)
+        void reportBackgroundIndexing() const {
+            if (!indexesReady()) {
+                return;
+            }
+            lock_guard<mutex> guard(indexLock);
+            if (indexReadySeconds >= 0) {
+                cout << "ID and name indexes ready for " << employees.size() << " employee(s), "
+                     << formatMoney(indexReadySeconds * 1000) << " ms after the load began." << endl;
+                indexReadySeconds = -1;
+            }
+        }
+        
+        // Returns whether an employee with the given ID is on the roster
+        bool hasEmployee(const string& id) const {
+            return !isIdUnique(id);
+        }
+        
+        // Returns the employee with the given ID, or nullptr
+        const Employee* findEmployee(const string& id) const {
+            if (indexesReady()) {
+                auto entry = idIndex.find(id);
+                return entry == idIndex.end() ? nullptr : employees[entry->second];
+            }
+            for (auto emp : employees) {
+                if (emp->getId() == id) {
+                    return emp;
+                }
+            }
+            return nullptr;
+        }
+        
+        // Returns the employees with the given name (case-insensitive), in roster order
+        vector<const Employee*> findEmployeesByName(const string& name) const {
+            vector<const Employee*> matches;
+            string key = nameKey(name);
+            if (indexesReady()) {
+                auto entry = nameIndex.find(key);
+                if (entry != nameIndex.end()) {
+                    for (size_t index : entry->second) {
+                        matches.push_back(employees[index]);
+                    }
+                }
+                return matches;
+            }
+            for (auto emp : employees) {
+                if (nameKey(emp->getName()) == key) {
+                    matches.push_back(emp);
+                }
+            }
+            return matches;
+        }
+        
+        size_t getEmployeeCount() const {
+            return employees.size();
+        }
+        
+        // Sums pay across the roster. Chunk partials are combined in chunk order, so the total
+        // is the same whether the sweep ran serially or in parallel.
+        double calculateTotalPayroll() const {
+            vector<double> partials(chunkCount(), 0.0);
+            adaptiveExecutor.parallelFor("sweep", partials.size(), [this, &partials](size_t first, size_t last) {
+                for (size_t chunk = first; chunk < last; ++chunk) {
+                    size_t end = min(employees.size(), (chunk + 1) * REPORT_CHUNK_SIZE);
+                    for (size_t i = chunk * REPORT_CHUNK_SIZE; i < end; ++i) {
+                        partials[chunk] += employees[i]->calculateSalary();
+                    }
+                }
+                return true;
+            }, REPORT_CHUNK_SIZE);
+            double total = 0.0;
+            for (double partial : partials) {
+                total += partial;
+            }
+            return total;
+        }
+        
+        // Writes the full payroll report text to out
+        bool writePayrollReport(ostream& out) const {
+            renderPayrollReport();
+            forEachReportPart([&out](string_view part) { out.write(part.data(), part.size()); });
+            return static_cast<bool>(out);
+        }
+        
+        // Copies the full payroll report into buffer with a terminating NUL, setting length to the
+        // report size; returns false (copying nothing) if capacity is not larger than the report
+        bool copyPayrollReport(char* buffer, size_t capacity, size_t& length) const {
+            renderPayrollReport();
+            length = 0;
+            forEachReportPart([&length](string_view part) { length += part.size(); });
+            if (capacity <= length) {
+                return false;
+            }
+            size_t offset = 0;
+            forEachReportPart([buffer, &offset](string_view part) {
+                memcpy(buffer + offset, part.data(), part.size());
+                offset += part.size();
+            });
+            buffer[length] = '\0';
+            return true;
+        }
+        
+        // Function to display payroll report
+        void displayPayrollReport() const {
+            OperationTimer timer("display report");
+            if (employees.empty()) {
+                cout << "No employees to display." << endl;
+                return;
+            }
+            
+            OperationProgress progress("Rendering report", employees.size(), progressCallback, cancellationToken);
+            bool rendered = renderPayrollReport([&progress](size_t count) { return progress.advance(count); });
+            progress.finish();
+            if (!rendered) {
+                cout << "Report cancelled." << endl;
+                return;
+            }
+            
+            // Served straight from the chunk texts; no formatting happens between mutations
+            forEachReportPart([](string_view part) { cout.write(part.data(), part.size()); });
+            cout.flush();
+        }
+        
+        // Returns the roster position of the employee with the given ID, or npos
+        size_t findEmployeePosition(const string& id) const {
+            if (indexesReady()) {
+                auto entry = idIndex.find(id);
+                return entry == idIndex.end() ? string::npos : entry->second;
+            }
+            for (size_t i = 0; i < employees.size(); ++i) {
+                if (employees[i]->getId() == id) {
+                    return i;
+                }
+            }
+            return string::npos;
+        }
+        
+        // Returns the position of the first employee at or after start (wrapping around) whose name
+        // matches text: an exact (case-insensitive) name through the name index, otherwise the
+        // first name containing text. Returns npos if none matches.
+        size_t findNameFrom(const string& text, size_t start) const {
+            string key = nameKey(text);
+            if (employees.empty() || key.empty()) {
+                return string::npos;
+            }
+            start %= employees.size();
+            if (indexesReady()) {
+                auto entry = nameIndex.find(key);
+                if (entry != nameIndex.end()) {
+                    // Positions are in roster order
+                    auto next = lower_bound(entry->second.begin(), entry->second.end(), start);
+                    return next != entry->second.end() ? *next : entry->second.front();
+                }
+            }
+            for (size_t step = 0; step < employees.size(); ++step) {
+                size_t i = (start + step) % employees.size();
+                if (nameKey(employees[i]->getName()).find(key) != string::npos) {
+                    return i;
+                }
+            }
+            return string::npos;
+        }
+        
+        // Interactive pager over the report: only the visible page of employees is rendered, so it
+        // opens instantly and uses constant memory whatever the roster size
+        void browsePayrollReport() const {
+            const size_t PAGE_SIZE = 5;
+            if (employees.empty()) {
+                cout << "No employees to display." << endl;
+                return;
+            }
+            
+            size_t top = 0;
+            while (true) {
+                size_t end = min(employees.size(), top + PAGE_SIZE);
+                cout << "\n------ Employee Payroll Report: " << (top + 1) << "-" << end << " of " << employees.size()
+                     << " ------\n";
+                for (size_t i = top; i < end; ++i) {
+                    cout << "#" << (i + 1) << " ";
+                    employees[i]->displayPayrollReport(cout);
+                    cout << "\n";
+                }
+                cout << "[Enter] next, [p] previous, [g N] go to #N, [j ID] jump to ID, [/text] find name, [q] quit: ";
+                string command = readInputLine();
+                
+                if (command.empty() || command == "n") {
+                    if (end == employees.size()) {
+                        cout << "End of report." << endl;
+                    } else {
+                        top = end;
+                    }
+                } else if (command == "p") {
+                    top = top >= PAGE_SIZE ? top - PAGE_SIZE : 0;
+                } else if (command == "q") {
+                    return;
+                } else if (command.compare(0, 2, "g ") == 0) {
+                    int position;
+                    if (isValidInteger(command.substr(2), position) && position >= 1 &&
+                        static_cast<size_t>(position) <= employees.size()) {
+                        top = position - 1;
+                    } else {
+                        cout << "Enter a position between 1 and " << employees.size() << "." << endl;
+                    }
+                } else if (command.compare(0, 2, "j ") == 0) {
+                    size_t position = findEmployeePosition(command.substr(2));
+                    if (position == string::npos) {
+                        cout << "No employee with ID " << command.substr(2) << "." << endl;
+                    } else {
+                        top = position;
+                    }
+                } else if (command[0] == '/') {
+                    // Search starts after the top employee, so repeating it moves to the next match
+                    size_t position = findNameFrom(command.substr(1), top + 1);
+                    if (position == string::npos) {
+                        cout << "No employee name matches \"" << command.substr(1) << "\"." << endl;
+                    } else {
+                        top = position;
+                    }
+                } else {
+                    cout << "Unknown command." << endl;
+                }
+            }
+        }
+        
+        // Function to save an incremental snapshot; only chunks not already stored are written
+        bool saveSnapshot(const string& directory) const {
+            OperationTimer timer("save snapshot", directory);
+            filesystem::path dir(directory);
+            error_code ec;
+            filesystem::create_directories(dir / "chunks", ec);
+            if (ec) {
+                cout << "Unable to create snapshot directory: " << directory << endl;
+                return false;
+            }
+            
+            unsigned long parent = readLatestSnapshot(dir);
+            unsigned long sequence = parent + 1;
+            size_t chunks = chunkCount();
+            size_t newChunks = 0;
+            uintmax_t bytesWritten = 0;
+            
+            // Manifest lists the full chunk sequence; unchanged chunks are shared with the parent by hash.
+            // With a key, chunks are named by a keyed hash (so names cannot confirm guessed records and
+            // differ per key), and an existing chunk is rewritten unless it is stored under this key.
+            ostringstream manifest;
+            manifest << "parent " << parent << "\n";
+            manifest << "employees " << employees.size() << "\n";
+            
+            // Chunks are encoded, hashed and encrypted in parallel a window at a time, then written in
+            // order; stored is left empty for chunks already on disk
+            vector<string> hashes, stored;
+            vector<size_t> sizes;
+            vector<char> encrypted; // char rather than bool so slots can be set concurrently
+            for (size_t first = 0; first < chunks; first += SNAPSHOT_WINDOW) {
+                size_t count = min(SNAPSHOT_WINDOW, chunks - first);
+                hashes.assign(count, string());
+                stored.assign(count, string());
+                sizes.assign(count, 0);
+                encrypted.assign(count, true);
+                adaptiveExecutor.parallelFor("snapshot", count, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        string data = serializeChunk(first + i);
+                        sizes[i] = data.size();
+                        hashes[i] = snapshotKey.empty() ? toHex(fnv1aHash(data)) : bytesToHex(hmacSha256(snapshotKey, data));
+                        if (storedChunkMatches(dir / "chunks" / (hashes[i] + ".chunk"), snapshotKey)) {
+                            continue;
+                        }
+                        if (snapshotKey.empty()) {
+                            stored[i] = move(data);
+                        } else {
+                            encrypted[i] = encryptChunk(snapshotKey, hashes[i], data, stored[i]);
+                        }
+                    }
+                    return true;
+                }, REPORT_CHUNK_SIZE);
+                
+                for (size_t i = 0; i < count; ++i) {
+                    if (!encrypted[i]) {
+                        cout << "Failed to encrypt snapshot chunk " << hashes[i] << endl;
+                        return false;
+                    }
+                    if (!stored[i].empty()) {
+                        filesystem::path chunkPath = dir / "chunks" / (hashes[i] + ".chunk");
+                        OperationTimer chunkTimer("write snapshot chunk", hashes[i]);
+                        if (!writeFileAtomically(chunkPath, stored[i])) {
+                            cout << "Failed to write snapshot chunk " << chunkPath.string() << endl;
+                            return false;
+                        }
+                        ++newChunks;
+                        bytesWritten += stored[i].size();
+                    }
+                    manifest << "chunk " << hashes[i] << " " << sizes[i] << "\n";
+                }
+            }
+            
+            string manifestData = manifest.str();
+            string manifestName = "manifest-" + to_string(sequence) + ".txt";
+            if (!writeFileAtomically(dir / manifestName, manifestData) ||
+                !writeFileAtomically(dir / "LATEST", to_string(sequence) + "\n")) {
+                cout << "Failed to write snapshot manifest." << endl;
+                return false;
+            }
+            bytesWritten += manifestData.size();
+            
+            cout << "Snapshot " << sequence << " saved: " << chunks << " chunk(s), "
+                 << newChunks << " new, " << bytesWritten << " bytes written." << endl;
+            return true;
+        }
+        
+        // Function to start a transaction that appends employees to the roster
+        Transaction beginTransaction() {
+            return Transaction(*this, false);
+        }
+        
+        // Function to restore the roster from the latest snapshot; the current roster is kept on failure
+        bool loadSnapshot(const string& directory) {
+            OperationTimer timer("load snapshot", directory);
+            auto loadStart = chrono::steady_clock::now();
+            filesystem::path dir(directory);
+            unsigned long sequence = readLatestSnapshot(dir);
+            if (sequence == 0) {
+                cout << "No snapshot found in " << directory << endl;
+                return false;
+            }
+            
+            ifstream manifest(dir / ("manifest-" + to_string(sequence) + ".txt"));
+            if (!manifest) {
+                cout << "Snapshot manifest " << sequence << " is missing." << endl;
+                return false;
+            }
+            
+            // The whole manifest is read first: its sizes let the load reserve the roster's memory up front
+            bool ok = true;
+            size_t total = 0;
+            size_t recordBytes = 0;
+            vector<pair<string, size_t>> chunks;
+            string key;
+            while (ok && manifest >> key) {
+                string hash;
+                size_t size;
+                if (key == "parent") {
+                    manifest >> key; // Informational field
+                } else if (key == "employees") {
+                    manifest >> total;
+                } else if (key == "chunk" && manifest >> hash >> size) {
+                    chunks.emplace_back(hash, size);
+                    recordBytes += size;
+                } else {
+                    ok = false;
+                }
+            }
+            
+            Transaction transaction(*this, true);
+            transaction.reserveAhead(estimateBatchBytes(total, recordBytes));
+            OperationProgress progress("Loading snapshot", total, progressCallback, cancellationToken);
+            
+            // Chunks are read, decrypted, verified and decoded in parallel a window at a time, then
+            // staged in manifest order
+            vector<vector<Employee*>> decoded;
+            vector<ChunkStatus> status;
+            for (size_t first = 0; ok && first < chunks.size(); first += SNAPSHOT_WINDOW) {
+                size_t count = min(SNAPSHOT_WINDOW, chunks.size() - first);
+                decoded.assign(count, vector<Employee*>());
+                status.assign(count, ChunkStatus::Ok);
+                adaptiveExecutor.parallelFor("snapshot", count, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        status[i] = readSnapshotChunk(dir, chunks[first + i].first, chunks[first + i].second, snapshotKey, decoded[i]);
+                    }
+                    return true;
+                }, REPORT_CHUNK_SIZE);
+                
+                for (size_t i = 0; i < count; ++i) {
+                    const string& hash = chunks[first + i].first;
+                    if (ok && status[i] == ChunkStatus::Undecryptable) {
+                        cout << "Snapshot chunk " << hash << " is encrypted and could not be decrypted"
+                             << (snapshotEncryptionAvailable() ? " (wrong or missing key)." : " (no encryption support in this build).") << endl;
+                        ok = false;
+                    } else if (ok && status[i] == ChunkStatus::Corrupted) {
+                        cout << "Snapshot chunk " << hash << " is missing or corrupted." << endl;
+                        ok = false;
+                    } else if (ok && status[i] == ChunkStatus::Malformed) {
+                        cout << "Snapshot chunk " << hash << " has a malformed record." << endl;
+                        ok = false;
+                    }
+                    size_t next = 0;
+                    for (; ok && next < decoded[i].size(); ++next) {
+                        if (!transaction.stage(decoded[i][next])) {
+                            cout << transaction.getError() << endl;
+                            ok = false;
+                        }
+                    }
+                    for (; next < decoded[i].size(); ++next) {
+                        delete decoded[i][next]; // Not staged
+                    }
+                    if (ok && !progress.advance(decoded[i].size())) {
+                        ok = false;
+                    }
+                }
+            }
+            
+            progress.finish();
+            if (progress.isCancelled()) {
+                cout << "Snapshot load cancelled." << endl;
+            }
+            if (!ok) {
+                cout << "Failed to load snapshot " << sequence << "; roster unchanged." << endl;
+                return false;
+            }
+            
+            if (!transaction.commit()) {
+                cout << transaction.getError() << endl << "Failed to load snapshot " << sequence << "; roster unchanged." << endl;
+                return false;
+            }
+            indexTimingStart = loadStart; // Index readiness is reported from the start of the load
+            cout << "Snapshot " << sequence << " loaded: " << employees.size() << " employee(s); ready for queries after "
+                 << formatMoney(chrono::duration<double>(chrono::steady_clock::now() - loadStart).count() * 1000)
+                 << " ms (ID and name indexes are built in the background)." << endl;
+            return true;
+        }
+        
+        // Helper function for bulk imports. The file is read into one buffer and records (lines) are
+        // sliced in place, parsed by several threads, then committed as one transaction; any invalid
+        // record aborts the import with the roster unchanged. Records are parsed a window at a time
+        // and each window is staged before the next is parsed, so parsing never runs ahead of the
+        // memory budget: staging waits while the budget is full (backpressure on the parsers).
+        bool importRecords(const string& path, const function<Employee*(string_view, string&)>& parseRecord) {
+            ifstream in(path, ios::binary);
+            if (!in) {
+                cout << "Unable to open " << path << endl;
+                return false;
+            }
+            string buffer((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+            
+            // Index record boundaries so workers can take contiguous ranges of records; blank lines
+            // are skipped, so each record keeps its line number in the file for error messages
+            vector<string_view> records;
+            vector<size_t> lineNumbers;
+            string_view data(buffer);
+            size_t start = 0;
+            size_t lineNumber = 0;
+            while (start < data.size()) {
+                ++lineNumber;
+                size_t end = data.find('\n', start);
+                if (end == string_view::npos) {
+                    end = data.size();
+                }
+                string_view record = data.substr(start, end - start);
+                if (!record.empty() && record.back() == '\r') {
+                    record.remove_suffix(1);
+                }
+                if (!record.empty()) {
+                    records.push_back(record);
+                    lineNumbers.push_back(lineNumber);
+                }
+                start = end + 1;
+            }
+            
+            // Parse each window (in parallel for large files); each slot keeps its record's position
+            // so order is preserved. After a failure the rest is still parsed to count invalid records.
+            const size_t IMPORT_WINDOW = 64 * 1024;
+            OperationProgress progress("Importing", records.size(), progressCallback, cancellationToken);
+            Transaction transaction(*this, false);
+            vector<Employee*> parsed;
+            vector<string> errors;
+            size_t failures = 0;
+            for (size_t first = 0; first < records.size(); first += IMPORT_WINDOW) {
+                size_t count = min(IMPORT_WINDOW, records.size() - first);
+                parsed.assign(count, nullptr);
+                errors.assign(count, string());
+                adaptiveExecutor.parallelFor("import", count, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        parsed[i] = parseRecord(records[first + i], errors[i]);
+                    }
+                    return progress.advance(end - begin);
+                });
+                if (progress.isCancelled()) {
+                    for (auto emp : parsed) {
+                        delete emp;
+                    }
+                    break;
+                }
+                
+                for (size_t i = 0; i < count; ++i) {
+                    if (parsed[i] == nullptr) {
+                        if (++failures <= 10) {
+                            cout << "Line " << lineNumbers[first + i] << ": " << errors[i] << endl;
+                        }
+                    } else if (failures == 0 && !transaction.stage(parsed[i])) {
+                        cout << "Line " << lineNumbers[first + i] << ": " << transaction.getError() << endl;
+                        ++failures;
+                    } else if (failures > 0) {
+                        delete parsed[i];
+                    }
+                    parsed[i] = nullptr;
+                }
+            }
+            progress.finish();
+            if (progress.isCancelled()) {
+                cout << "Import cancelled; roster unchanged." << endl;
+                return false;
+            }
+            if (failures > 0) {
+                cout << "Import failed (" << failures << " invalid record(s)); roster unchanged." << endl;
+                return false;
+            }
+            
+            if (!transaction.commit()) {
+                cout << transaction.getError() << endl << "Import failed; roster unchanged." << endl;
+                return false;
+            }
+            cout << "Imported " << records.size() << " employee(s) from " << path << "." << endl;
+            return true;
+        }
+        
+        // Function to import a legacy fixed-width export
+        bool importFixedWidth(const string& path, const FixedWidthLayout& layout) {
+            OperationTimer timer("import fixed-width", path);
+            return importRecords(path, [&layout](string_view record, string& error) {
+                return parseFixedWidthRecord(record, layout, error);
+            });
+        }
+        
+        // Function to import employees from an NDJSON file (one JSON object per line)
+        bool importNdjson(const string& path) {
+            OperationTimer timer("import ndjson", path);
+            return importRecords(path, parseNdjsonRecord);
+        }
+        
+        // Function to report probable duplicate people onboarded under different IDs.
+        // Names are blocked with MinHash/LSH so only employees sharing a band bucket are compared.
+        void findProbableDuplicates() const {
+            OperationTimer timer("find duplicates");
+            const double NAME_THRESHOLD = 0.7;      // Similar names alone
+            const double SAME_PAY_THRESHOLD = 0.5;  // Weaker name match backed by identical pay
+            const size_t MAX_BUCKET_SIZE = 1000;    // Larger buckets (common names) get an exact-name pass instead
+            const size_t MAX_PAIRS_SHOWN = 100;
+            
+            // Compute signatures over employee ranges, in parallel for large rosters
+            OperationProgress progress("Finding duplicates", employees.size(), progressCallback, cancellationToken);
+            vector<vector<uint64_t>> signatures(employees.size());
+            adaptiveExecutor.parallelFor("duplicates", employees.size(), [this, &signatures, &progress](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    signatures[i] = nameSignature(employees[i]->getName());
+                }
+                return progress.advance(end - begin);
+            });
+            progress.finish();
+            if (progress.isCancelled()) {
+                cout << "Duplicate search cancelled." << endl;
+                return;
+            }
+            
+            // Bucket employees by each band of their signature
+            vector<uint64_t> bandKeys(employees.size() * MINHASH_BANDS);
+            unordered_map<uint64_t, vector<size_t>> buckets;
+            for (size_t i = 0; i < employees.size(); ++i) {
+                for (int band = 0; band < MINHASH_BANDS; ++band) {
+                    uint64_t key = mixHash(band);
+                    for (int row = 0; row < MINHASH_ROWS; ++row) {
+                        key = mixHash(key ^ signatures[i][band * MINHASH_ROWS + row]);
+                    }
+                    bandKeys[i * MINHASH_BANDS + band] = key;
+                    buckets[key].push_back(i);
+                }
+            }
+            
+            vector<bool> comparable(bandKeys.size());
+            vector<bool> inOversizedBucket(employees.size(), false);
+            for (size_t slot = 0; slot < bandKeys.size(); ++slot) {
+                comparable[slot] = buckets[bandKeys[slot]].size() <= MAX_BUCKET_SIZE;
+                if (!comparable[slot]) {
+                    inOversizedBucket[slot / MINHASH_BANDS] = true;
+                }
+            }
+            
+            // A pair sharing several buckets is only compared in the first comparable one, or -1 if none
+            auto comparedInBand = [&bandKeys, &comparable](size_t a, size_t b) {
+                for (int band = 0; band < MINHASH_BANDS; ++band) {
+                    size_t slot = a * MINHASH_BANDS + band;
+                    if (comparable[slot] && bandKeys[slot] == bandKeys[b * MINHASH_BANDS + band]) {
+                        return band;
+                    }
+                }
+                return -1;
+            };
+            
+            // Matches are kept sorted by roster position; only the first MAX_PAIRS_SHOWN are retained
+            struct Match {
+                size_t first;
+                size_t second;
+                double similarity;
+                bool samePay;
+                
+                bool operator<(const Match& other) const {
+                    return first != other.first ? first < other.first : second < other.second;
+                }
+            };
+            vector<Match> matches;
+            size_t found = 0;
+            auto addMatch = [&](const Match& match) {
+                ++found;
+                matches.push_back(match);
+                if (matches.size() >= 2 * MAX_PAIRS_SHOWN) {
+                    nth_element(matches.begin(), matches.begin() + MAX_PAIRS_SHOWN, matches.end());
+                    matches.resize(MAX_PAIRS_SHOWN);
+                }
+            };
+            auto samePay = [this](size_t a, size_t b) {
+                const Employee* first = employees[a];
+                const Employee* second = employees[b];
+                return typeid(*first) == typeid(*second) && first->calculateSalary() == second->calculateSalary();
+            };
+            
+            // Verify candidate pairs that share at least one bucket
+            for (const auto& bucket : buckets) {
+                const vector<size_t>& members = bucket.second;
+                if (progress.isCancelled()) {
+                    cout << "Duplicate search cancelled." << endl;
+                    return;
+                }
+                if (members.size() > MAX_BUCKET_SIZE) {
+                    continue;
+                }
+                for (size_t x = 0; x < members.size(); ++x) {
+                    for (size_t y = x + 1; y < members.size(); ++y) {
+                        size_t a = members[x];
+                        size_t b = members[y];
+                        // A bucket key can collide across bands, so members need not share a band at all
+                        int band = comparedInBand(a, b);
+                        if (band < 0 || bandKeys[a * MINHASH_BANDS + band] != bucket.first) {
+                            continue;
+                        }
+                        double similarity = signatureSimilarity(signatures[a], signatures[b]);
+                        bool pay = samePay(a, b);
+                        if (similarity >= NAME_THRESHOLD || (pay && similarity >= SAME_PAY_THRESHOLD)) {
+                            addMatch({a, b, similarity, pay});
+                        }
+                    }
+                }
+            }
+            
+            // Very common names fill buckets too large to compare pairwise; those employees are
+            // instead grouped by exact normalized name, each reported against the group's first member
+            unordered_map<string, size_t> firstWithName;
+            for (size_t i = 0; i < employees.size(); ++i) {
+                if (!inOversizedBucket[i]) {
+                    continue;
+                }
+                auto inserted = firstWithName.emplace(normalizeName(employees[i]->getName()), i);
+                size_t first = inserted.first->second;
+                if (inserted.second || comparedInBand(first, i) >= 0) {
+                    continue;
+                }
+                addMatch({first, i, 1.0, samePay(first, i)});
+            }
+            
+            sort(matches.begin(), matches.end());
+            if (matches.size() > MAX_PAIRS_SHOWN) {
+                matches.resize(MAX_PAIRS_SHOWN);
+            }
+            for (const Match& match : matches) {
+                const Employee* first = employees[match.first];
+                const Employee* second = employees[match.second];
+                cout << first->getName() << " (ID: " << first->getId() << ") and "
+                     << second->getName() << " (ID: " << second->getId() << ")"
+                     << " - name similarity " << static_cast<int>(match.similarity * 100) << "%"
+                     << (match.samePay ? ", same pay" : "") << endl;
+            }
+            if (found == 0) {
+                cout << "No probable duplicates found." << endl;
+            } else if (found > MAX_PAIRS_SHOWN) {
+                cout << "... and " << (found - MAX_PAIRS_SHOWN) << " more." << endl;
+            }
+        }
+        
+        // Records every employee's current pay as the pay period of payDate (YYYY-MM-DD) in the
+        // history directory. A date is recorded once; a second run for it is refused rather than
+        // overwriting the first or counting as an extra period in forecasts.
+        bool recordPayPeriod(const string& directory, const string& payDate) const {
+            OperationTimer timer("record pay period", directory);
+            filesystem::path dir(directory);
+            error_code ec;
+            filesystem::create_directories(dir, ec);
+            filesystem::path path = dir / ("period-" + payDate + ".txt");
+            if (filesystem::exists(path, ec)) {
+                cout << "Pay period " << payDate << " is already recorded; this run was not added to the pay history." << endl;
+                return false;
+            }
+            
+            ostringstream out;
+            out.precision(numeric_limits<double>::max_digits10);
+            out << "# period " << payDate << "\n";
+            for (auto emp : employees) {
+                out << emp->getId() << " " << emp->calculateSalary() << "\n";
+            }
+            if (!writeFileAtomically(path, out.str())) {
+                cout << "Unable to record pay period in " << directory << endl;
+                return false;
+            }
+            cout << "Pay period " << payDate << " recorded for forecasting." << endl;
+            return true;
+        }
+        
+        // Forecasts next-period pay for every employee of the latest stored period from up to
+        // maxPeriods periods of history. The history is loaded into an employee x period matrix;
+        // each employee's row is then fitted in one pass (a least-squares linear trend and simple
+        // exponential smoothing), in parallel across employees. Per-employee forecasts are written
+        // as CSV to outputPath. Returns false if there is no history, the forecast was cancelled or
+        // the CSV could not be written.
+        bool forecastPay(const string& directory, size_t maxPeriods, const string& outputPath, ForecastResult& result) const {
+            OperationTimer timer("forecast pay", directory);
+            const double SMOOTHING_ALPHA = 0.5; // Weight of the newest period in exponential smoothing
+            filesystem::path dir(directory);
+            vector<filesystem::path> periodFiles = listPayPeriods(dir);
+            if (periodFiles.empty() || maxPeriods == 0) {
+                cout << "No pay history in " << directory << "; run payroll to record pay periods." << endl;
+                return false;
+            }
+            if (periodFiles.size() > maxPeriods) {
+                periodFiles.erase(periodFiles.begin(), periodFiles.end() - maxPeriods);
+            }
+            size_t periods = periodFiles.size();
+            
+            // Rows are the employees of the latest period
+            vector<string> ids;
+            vector<double> lastPay;
+            if (!forEachPayRecord(periodFiles.back(), [&](string_view id, double pay) {
+                    ids.emplace_back(id);
+                    lastPay.push_back(pay);
+                })) {
+                cout << "Unable to read pay period " << periodFiles.back().string() << endl;
+                return false;
+            }
+            
+            // Periods are written in roster order, so a record is usually in the row after the
+            // previous one; the ID -> row map is only built if some period is out of step
+            unordered_map<string_view, size_t> rows;
+            once_flag rowsBuilt;
+            auto findRow = [&](string_view id, size_t expected) {
+                if (expected < ids.size() && ids[expected] == id) {
+                    return expected;
+                }
+                call_once(rowsBuilt, [&]() {
+                    rows.reserve(ids.size());
+                    for (size_t row = 0; row < ids.size(); ++row) {
+                        rows.emplace(ids[row], row);
+                    }
+                });
+                auto row = rows.find(id);
+                return row == rows.end() ? ids.size() : row->second;
+            };
+            
+            // Fill the matrix one period (column) per task; missing periods and employees stay NaN
+            vector<double> matrix(ids.size() * periods, numeric_limits<double>::quiet_NaN());
+            for (size_t row = 0; row < ids.size(); ++row) {
+                matrix[row * periods + periods - 1] = lastPay[row];
+            }
+            adaptiveExecutor.parallelFor("history", periods - 1, [&](size_t begin, size_t end) {
+                for (size_t column = begin; column < end; ++column) {
+                    size_t expected = 0;
+                    forEachPayRecord(periodFiles[column], [&](string_view id, double pay) {
+                        size_t row = findRow(id, expected);
+                        if (row < ids.size()) {
+                            matrix[row * periods + column] = pay;
+                            expected = row + 1;
+                        }
+                    });
+                }
+                return true;
+            }, static_cast<double>(ids.size()));
+            
+            // Fit every employee's row in one pass
+            vector<double> trend(ids.size()), smoothed(ids.size());
+            OperationProgress progress("Forecasting", ids.size(), progressCallback, cancellationToken);
+            bool completed = adaptiveExecutor.parallelFor("forecast", ids.size(), [&](size_t begin, size_t end) {
+                for (size_t row = begin; row < end; ++row) {
+                    const double* history = matrix.data() + row * periods;
+                    double n = 0, sumX = 0, sumY = 0, sumXY = 0, sumXX = 0, level = 0;
+                    for (size_t x = 0; x < periods; ++x) {
+                        double y = history[x];
+                        if (isnan(y)) {
+                            continue;
+                        }
+                        level = n == 0 ? y : SMOOTHING_ALPHA * y + (1 - SMOOTHING_ALPHA) * level;
+                        n += 1;
+                        sumX += x;
+                        sumY += y;
+                        sumXY += x * y;
+                        sumXX += static_cast<double>(x) * x;
+                    }
+                    double denominator = n * sumXX - sumX * sumX;
+                    double forecast = level;
+                    if (n >= 2 && denominator > 0) {
+                        double slope = (n * sumXY - sumX * sumY) / denominator;
+                        forecast = (sumY - slope * sumX) / n + slope * periods;
+                    }
+                    trend[row] = max(0.0, forecast);
+                    smoothed[row] = level;
+                }
+                return progress.advance(end - begin);
+            });
+            progress.finish();
+            if (!completed) {
+                return false;
+            }
+            
+            // Totals are summed in row order so they do not depend on threading
+            result = ForecastResult();
+            result.periods = periods;
+            result.employees = ids.size();
+            string csv = "id,last_pay,trend_forecast,smoothed_forecast\n";
+            for (size_t row = 0; row < ids.size(); ++row) {
+                result.lastTotal += lastPay[row];
+                result.trendTotal += trend[row];
+                result.smoothedTotal += smoothed[row];
+                
+                // Shortest round-trip formatting, much faster than a stream for millions of rows
+                char line[128];
+                char* end = line;
+                for (double value : {lastPay[row], trend[row], smoothed[row]}) {
+                    *end++ = ',';
+                    end = to_chars(end, line + sizeof(line), value).ptr;
+                }
+                *end++ = '\n';
+                csv += ids[row];
+                csv.append(line, end);
+            }
+            if (!writeFileAtomically(outputPath, csv)) {
+                cout << "Unable to write " << outputPath << endl;
+                return false;
+            }
+            return true;
+        }
+        
+        // Monte Carlo simulation of the payroll cost over the next settings.months months. Trials
+        // run in batches across threads, each batch computing the pay formulas column by column
+        // over its trials; the result is reproducible for a given seed. Returns false if cancelled.
+        bool simulateCost(const SimulationSettings& settings, SimulationResult& result) const {
+            OperationTimer timer("simulate cost", settings.trials, "trial(s)");
+            const size_t TRIAL_BATCH = 256;
+            
+            // Columns of the uncertain inputs; full-time pay is a constant
+            double fixedMonthly = 0, currentMonthly = 0;
+            vector<double> wages, hours, payments, projects;
+            for (auto emp : employees) {
+                currentMonthly += emp->calculateSalary();
+                if (auto partTime = dynamic_cast<const PartTimeEmployee*>(emp)) {
+                    wages.push_back(partTime->getHourlyWage());
+                    hours.push_back(partTime->getHoursWorked());
+                } else if (auto contractual = dynamic_cast<const ContractualEmployee*>(emp)) {
+                    payments.push_back(contractual->getPaymentPerProject());
+                    projects.push_back(contractual->getProjectsCompleted());
+                } else {
+                    fixedMonthly += emp->calculateSalary();
+                }
+            }
+            
+            vector<double> costs(settings.trials);
+            size_t batches = (settings.trials + TRIAL_BATCH - 1) / TRIAL_BATCH;
+            size_t months = settings.months;
+            uint64_t seed = settings.seed;
+            OperationProgress progress("Simulating", settings.trials, progressCallback, cancellationToken);
+            bool completed = adaptiveExecutor.parallelFor("simulation", batches, [&](size_t first, size_t last) {
+                for (size_t b = first; b < last; ++b) {
+                    size_t begin = b * TRIAL_BATCH;
+                    size_t count = min(settings.trials, begin + TRIAL_BATCH) - begin;
+                    double* batch = costs.data() + begin;
+                    fill(batch, batch + count, fixedMonthly * months);
+                    for (size_t month = 0; month < months; ++month) {
+                        for (size_t i = 0; i < wages.size(); ++i) {
+                            uint64_t pair = i * months + month;
+                            for (size_t t = 0; t < count; ++t) {
+                                double sampled = hours[i] * (1 + settings.hoursSpread * counterNormal(seed, begin + t, pair));
+                                batch[t] += wages[i] * max(0.0, sampled);
+                            }
+                        }
+                        for (size_t j = 0; j < payments.size(); ++j) {
+                            uint64_t pair = (wages.size() + j) * months + month;
+                            for (size_t t = 0; t < count; ++t) {
+                                batch[t] += payments[j] * counterPoisson(projects[j], seed, begin + t, pair);
+                            }
+                        }
+                    }
+                    if (!progress.advance(count)) {
+                        return false;
+                    }
+                }
+                return true;
+            }, static_cast<double>(TRIAL_BATCH * (wages.size() + payments.size()) * months));
+            progress.finish();
+            if (!completed) {
+                return false;
+            }
+            
+            // Summed in trial order so the mean does not depend on threading
+            result.trials = settings.trials;
+            result.currentCost = currentMonthly * months;
+            result.mean = 0;
+            for (double cost : costs) {
+                result.mean += cost;
+            }
+            result.mean /= max<size_t>(1, costs.size());
+            sort(costs.begin(), costs.end());
+            result.percentiles.clear();
+            for (double percentile : {1.0, 5.0, 25.0, 50.0, 75.0, 95.0, 99.0}) {
+                size_t rank = static_cast<size_t>(ceil(percentile / 100 * costs.size()));
+                result.percentiles.emplace_back(percentile, costs.empty() ? 0 : costs[max<size_t>(1, rank) - 1]);
+            }
+            return true;
+        }
+        
+        // Function to run payroll as a task graph over employee chunks. Each chunk is validated and
+        // paid independently (checkpointing each completed chunk so an interrupted run resumes from
+        // the last completed chunk), then the partial totals are aggregated; the report renders alongside.
+        bool runPayroll(const string& checkpointPath) const {
+            OperationTimer timer("payroll run");
+            // Completed chunks from a previous interrupted run: chunk -> (content hash, partial total)
+            map<size_t, pair<string, double>> completed;
+            {
+                // Each marker line ends with a checksum of the rest of the line, so a marker cut off
+                // mid-write (e.g. a total of "1234" instead of "1234.5678") is ignored
+                ifstream previous(checkpointPath);
+                string line;
+                while (getline(previous, line)) {
+                    size_t checksumStart = line.rfind(' ');
+                    if (checksumStart == string::npos || line.substr(checksumStart + 1) != toHex(fnv1aHash(line.substr(0, checksumStart)))) {
+                        continue;
+                    }
+                    istringstream marker(line.substr(0, checksumStart));
+                    string key, hash, total;
+                    size_t chunk;
+                    double value;
+                    if (marker >> key >> chunk >> hash >> total && key == "done" &&
+                        from_chars(total.data(), total.data() + total.size(), value).ec == errc()) {
+                        completed[chunk] = make_pair(hash, value);
+                    }
+                }
+            }
+            
+            // A marker torn by a crash has no line break; start the next one on a fresh line
+            bool tornTail = false;
+            {
+                ifstream previous(checkpointPath, ios::binary | ios::ate);
+                if (previous && previous.tellg() > 0) {
+                    previous.seekg(-1, ios::end);
+                    tornTail = previous.get() != '\n';
+                }
+            }
+            ofstream checkpoint(checkpointPath, ios::app);
+            if (!checkpoint) {
+                cout << "Unable to open payroll checkpoint " << checkpointPath << endl;
+                return false;
+            }
+            if (tornTail) {
+                checkpoint << "\n";
+            }
+            mutex checkpointLock;
+            
+            size_t chunks = chunkCount();
+            vector<string> hashes(chunks);
+            vector<vector<bool>> invalid(chunks);
+            vector<double> chunkTotals(chunks, 0.0);
+            atomic<size_t> resumed(0);
+            size_t invalidCount = 0;
+            double totalPayroll = 0.0;
+            
+            OperationProgress progress("Payroll run", employees.size(), progressCallback, cancellationToken);
+            TaskGraph graph;
+            vector<size_t> payTasks;
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                size_t begin = chunk * REPORT_CHUNK_SIZE;
+                size_t end = min(employees.size(), begin + REPORT_CHUNK_SIZE);
+                
+                // Validate: fingerprint the chunk and flag employees whose pay cannot be computed
+                size_t validate = graph.addTask("validate", [this, &hashes, &invalid, &progress, chunk, begin, end]() {
+                    if (progress.isCancelled()) {
+                        return;
+                    }
+                    hashes[chunk] = toHex(fnv1aHash(serializeChunk(chunk)));
+                    invalid[chunk].assign(end - begin, false);
+                    for (size_t i = begin; i < end; ++i) {
+                        double pay = employees[i]->calculateSalary();
+                        invalid[chunk][i - begin] = !isfinite(pay) || pay < 0;
+                    }
+                });
+                
+                // Compute pay, reusing a checkpoint marker if the chunk is unchanged since it was written
+                payTasks.push_back(graph.addTask("compute pay", [&, chunk, begin, end]() {
+                    if (hashes[chunk].empty() || progress.isCancelled()) {
+                        return; // Cancelled; this chunk is left for the resumed run
+                    }
+                    auto marker = completed.find(chunk);
+                    if (marker != completed.end() && marker->second.first == hashes[chunk]) {
+                        chunkTotals[chunk] = marker->second.second;
+                        ++resumed;
+                        progress.advance(end - begin);
+                        return;
+                    }
+                    double chunkTotal = 0.0;
+                    for (size_t i = begin; i < end; ++i) {
+                        if (!invalid[chunk][i - begin]) {
+                            chunkTotal += employees[i]->calculateSalary();
+                        }
+                    }
+                    chunkTotals[chunk] = chunkTotal;
+                    {
+                        char total[64];
+                        string line = "done " + to_string(chunk) + " " + hashes[chunk] + " " +
+                                      string(total, to_chars(total, total + sizeof(total), chunkTotal).ptr);
+                        lock_guard<mutex> guard(checkpointLock);
+                        checkpoint << line << " " << toHex(fnv1aHash(line)) << endl;
+                    }
+                    progress.advance(end - begin);
+                }, {validate}));
+            }
+            
+            // Aggregate: partial totals are always combined in chunk order, so a resumed or
+            // concurrent run produces exactly the same total as an uninterrupted serial one
+            graph.addTask("aggregate", [&]() {
+                for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                    totalPayroll += chunkTotals[chunk];
+                    invalidCount += count(invalid[chunk].begin(), invalid[chunk].end(), true);
+                }
+            }, payTasks);
+            
+            // Render the report concurrently so the next display is served from the cache
+            graph.addTask("render report", [this, &progress]() {
+                renderPayrollReport([&progress](size_t) { return !progress.isCancelled(); }, false);
+            });
+            
+            // Small rosters run serially; the thread count grows with the estimated work
+            size_t threads = adaptiveExecutor.choose("payroll", employees.size()).threads;
+            auto start = chrono::steady_clock::now();
+            graph.run(threads);
+            double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            progress.finish();
+            checkpoint.close();
+            
+            if (progress.isCancelled()) {
+                cout << "Payroll run cancelled; completed chunks are checkpointed and the next run resumes from them." << endl;
+                return false;
+            }
+            adaptiveExecutor.recordCost("payroll", employees.size(), threads, wallSeconds);
+            
+            // The run finished; the next run starts from scratch
+            error_code ec;
+            filesystem::remove(checkpointPath, ec);
+            
+            if (resumed > 0) {
+                cout << "Resumed " << resumed << " of " << chunks << " chunk(s) from checkpoint." << endl;
+            }
+            if (invalidCount > 0) {
+                cout << "Warning: " << invalidCount << " employee(s) with invalid pay were excluded." << endl;
+            }
+            cout << "Payroll run complete: " << employees.size() << " employee(s), total payroll $"
+                 << formatMoney(totalPayroll) << endl;
+            cout << "Stage timing (ms):";
+            for (const auto& stage : graph.getStageSeconds()) {
+                cout << " " << stage.first << " " << formatMoney(stage.second * 1000) << ";";
+            }
+            cout << " wall " << formatMoney(wallSeconds * 1000) << " on " << threads << " thread(s)" << endl;
+            return true;
+        }
+};
+
+// ---- C interface (payroll.h) ----
+
+struct payroll_system {
+    PayrollSystem roster;
+};
+
+// Helper function to run a C interface call, keeping exceptions from crossing the C boundary
+template <typename Call>
+payroll_status guardedCall(Call call) {
+    try {
+        return call();
+    } catch (...) {
+        return PAYROLL_INTERNAL_ERROR;
+    }
+}
+
+// Helper function to write a number the way a user would type it: plain decimal digits, no
+// exponent, as few fraction digits as represent it exactly (so 12.5 is "12.5" and 0.125 "0.125")
+string numberAsTyped(double value) {
+    char text[400]; // Enough for any finite double in fixed notation
+    to_chars_result written = to_chars(text, text + sizeof(text), value, chars_format::fixed);
+    return written.ec == errc() ? string(text, written.ptr) : string();
+}
+
+// Helper function to validate an employee passed through the C interface and create it, with
+// the same rules as the console prompts; returns nullptr if any field is invalid
+Employee* employeeFromC(const payroll_employee* employee) {
+    if (employee == nullptr || employee->id == nullptr || employee->name == nullptr) {
+        return nullptr;
+    }
+    const char* types[] = {"F", "P", "C"};
+    if (employee->type < PAYROLL_FULL_TIME || employee->type > PAYROLL_CONTRACTUAL) {
+        return nullptr;
+    }
+    string error;
+    return createValidatedEmployee(types[employee->type], employee->id, employee->name,
+                                   numberAsTyped(employee->amount), numberAsTyped(employee->quantity), error);
+}
+
+extern "C" {
+
+int payroll_api_version(void) {
+    return PAYROLL_API_VERSION;
+}
+
+const char* payroll_status_message(payroll_status status) {
+    switch (status) {
+        case PAYROLL_OK:
+            return "success";
+        case PAYROLL_INVALID_ARGUMENT:
+            return "invalid argument";
+        case PAYROLL_DUPLICATE_ID:
+            return "duplicate employee ID";
+        case PAYROLL_NOT_FOUND:
+            return "employee not found";
+        case PAYROLL_BUFFER_TOO_SMALL:
+            return "buffer too small";
+        case PAYROLL_MEMORY_BUDGET:
+            return "memory budget exceeded";
+        case PAYROLL_INTERNAL_ERROR:
+            return "internal error";
+        case PAYROLL_IO_ERROR:
+            return "file could not be opened or written";
+    }
+    return "unknown status";
+}
+
+payroll_system* payroll_create(void) {
+    try {
+        return new payroll_system();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void payroll_destroy(payroll_system* system) {
+    delete system;
+}
+
+payroll_status payroll_open_audit(payroll_system* system, const char* path) {
+    if (system == nullptr || path == nullptr || *path == '\0') {
+        return PAYROLL_INVALID_ARGUMENT;
+    }
+    return guardedCall([&]() {
+        return system->roster.openAuditLog(path) ? PAYROLL_OK : PAYROLL_IO_ERROR;
+    });
+}
+
+payroll_status payroll_set_memory_budget(payroll_system* system, size_t bytes) {
+    if (system == nullptr) {
+        return PAYROLL_INVALID_ARGUMENT;
+    }
+    system->roster.setMemoryBudget(bytes);
+    return PAYROLL_OK;
+}
+
+payroll_status payroll_add(payroll_system* system, const payroll_employee* employee) {
+    return payroll_add_batch(system, employee, 1, nullptr);
+}
+
+payroll_status payroll_add_batch(payroll_system* system, const payroll_employee* employees, size_t count,
+                                 size_t* failed_index) {
+    if (system == nullptr || (employees == nullptr && count > 0)) {
+        return PAYROLL_INVALID_ARGUMENT;
+    }
+    return guardedCall([&]() {
+        auto transaction = system->roster.beginTransaction();
+        for (size_t i = 0; i < count; ++i) {
+            Employee* emp = employeeFromC(&employees[i]);
+            payroll_status status = PAYROLL_OK;
+            if (emp == nullptr) {
+                status = PAYROLL_INVALID_ARGUMENT;
+            } else if (system->roster.hasEmployee(emp->getId())) {
+                delete emp;
+                status = PAYROLL_DUPLICATE_ID;
+            } else if (!transaction.stage(emp)) {
+                status = transaction.getFailure() == PayrollSystem::Failure::DuplicateId ? PAYROLL_DUPLICATE_ID : PAYROLL_MEMORY_BUDGET;
+            }
+            if (status != PAYROLL_OK) {
+                if (failed_index != nullptr) {
+                    *failed_index = i;
+                }
+                return status; // The transaction rolls back
+            }
+        }
+        if (!transaction.commit()) {
+            return transaction.getFailure() == PayrollSystem::Failure::DuplicateId ? PAYROLL_DUPLICATE_ID : PAYROLL_MEMORY_BUDGET;
+        }
+        return PAYROLL_OK;
+    });
+}
+
+payroll_status payroll_lookup(const payroll_system* system, const char* id, payroll_lookup_result* result) {
+    if (system == nullptr || id == nullptr || result == nullptr) {
+        return PAYROLL_INVALID_ARGUMENT;
+    }
+    return guardedCall([&]() {
+        const Employee* emp = system->roster.findEmployee(id);
+        if (emp == nullptr) {
+            return PAYROLL_NOT_FOUND;
+        }
+        result->type = dynamic_cast<const FullTimeEmployee*>(emp) ? PAYROLL_FULL_TIME
+                     : dynamic_cast<const PartTimeEmployee*>(emp) ? PAYROLL_PART_TIME : PAYROLL_CONTRACTUAL;
+        result->name = emp->getName().c_str();
+        result->pay = emp->calculateSalary();
+        return PAYROLL_OK;
+    });
+}
+
+size_t payroll_count(const payroll_system* system) {
+    return system == nullptr ? 0 : system->roster.getEmployeeCount();
+}
+
+payroll_status payroll_total(const payroll_system* system, double* total) {
+    if (system == nullptr || total == nullptr) {
+        return PAYROLL_INVALID_ARGUMENT;
+    }
+    return guardedCall([&]() {
+        *total = system->roster.calculateTotalPayroll();
+        return PAYROLL_OK;
+    });
+}
+
+payroll_status payroll_report(const payroll_system* system, char* buffer, size_t capacity, size_t* length) {
+    if (system == nullptr || length == nullptr || (buffer == nullptr && capacity > 0)) {
+        return PAYROLL_INVALID_ARGUMENT;
+    }
+    return guardedCall([&]() {
+        return system->roster.copyPayrollReport(buffer, capacity, *length) ? PAYROLL_OK : PAYROLL_BUFFER_TOO_SMALL;
+    });
+}
+
+}
+
+// Everything below is the console program (menu, benchmarks, scheduler, self-checks), which the
+// library build leaves out
+#ifndef PAYROLL_LIBRARY
+
+// Menu numbers used outside the menu itself (the subprocess benchmark drives the menu)
+const int MENU_DISPLAY_REPORT = 4;
+const int MENU_EXIT = 15;
+
+// Version of the menu numbering and prompts, written into recorded sessions; bump it whenever
+// options are renumbered or prompts change order so older recordings are refused on replay
+const int MENU_VERSION = 1;
+
+// Directory holding the roster snapshots (chunk store and manifests)
+const string SNAPSHOT_DIRECTORY = "payroll_snapshots";
+
+// Tamper-evident audit log of roster changes
+const string AUDIT_LOG_FILE = "payroll_audit.log";
+
+// Checkpoint file recording completed chunks of an in-progress payroll run
+const string PAYROLL_CHECKPOINT_FILE = "payroll_run.checkpoint";
+
+// Payroll report exported by scheduled export jobs (in each tenant's directory)
+const string PAYROLL_REPORT_FILE = "payroll_report.txt";
+
+// Pay recorded by each completed payroll run, and the per-employee forecasts made from it
+const string PAY_HISTORY_DIRECTORY = "payroll_history";
+const string PAY_FORECAST_FILE = "payroll_forecast.csv";
+
+// Reads the optional snapshot encryption key from PAYROLL_SNAPSHOT_KEY (64 hexadecimal digits,
+// an AES-256 key); key is left empty if the variable is unset. Returns false with the reason in
+// error if the variable is set but the key cannot be used.
+bool readSnapshotKeySetting(string& key, string& error) {
+    key.clear();
+    const char* keyHex = getenv("PAYROLL_SNAPSHOT_KEY");
+    if (keyHex == nullptr) {
+        return true;
+    }
+    if (!snapshotEncryptionAvailable()) {
+        error = "PAYROLL_SNAPSHOT_KEY is set but this build has no encryption support";
+        return false;
+    }
+    if (!parseHex(keyHex, key) || key.size() != 32) {
+        key.clear();
+        error = "PAYROLL_SNAPSHOT_KEY must be 64 hexadecimal digits";
+        return false;
+    }
+    return true;
+}
+
+// Reads the optional memory budget for employee records from PAYROLL_MEMORY_BUDGET_MB (e.g. 512);
+// returns 0 (unlimited) if the variable is unset or not a positive number
+size_t readMemoryBudgetSetting() {
+    const char* budget = getenv("PAYROLL_MEMORY_BUDGET_MB");
+    int megabytes;
+    if (budget != nullptr && isValidInteger(budget, megabytes) && megabytes > 0) {
+        return static_cast<size_t>(megabytes) * 1024 * 1024;
+    }
+    return 0;
+}
+
+// Cancellation of the console command in progress (set by Ctrl+C while a long operation runs)
+CancellationToken consoleCancellation;
+atomic<bool> longOperationRunning{false};
+
+// SIGINT handler: cancels a running long operation, otherwise interrupts the program as usual
+void handleInterrupt(int signalNumber) {
+    if (longOperationRunning.load()) {
+        signal(signalNumber, handleInterrupt); // Some platforms reset the handler on delivery
+        consoleCancellation.cancel();
+    } else {
+        signal(signalNumber, SIG_DFL);
+        raise(signalNumber);
+    }
+}
+
+// Marks a long operation as running for its scope, so Ctrl+C cancels it; the flag and the
+// cancellation are cleared on every exit, including when the operation throws
+class LongOperationScope {
+    public:
+        LongOperationScope() {
+            consoleCancellation.reset();
+            longOperationRunning = true;
+        }
+        
+        ~LongOperationScope() {
+            longOperationRunning = false;
+            consoleCancellation.reset();
+        }
+        
+        LongOperationScope(const LongOperationScope&) = delete;
+        LongOperationScope& operator=(const LongOperationScope&) = delete;
+};
+
+// Runs a long operation that Ctrl+C cancels instead of ending the program
+void runCancellable(const function<void()>& operation) {
+    LongOperationScope scope;
+    operation();
+}
+
+// Shows progress of long operations on one console line (throughput and time remaining)
+void showProgress(const ProgressReport& report) {
+    cout << "\r" << report.operation << ": " << report.recordsDone << "/" << report.recordsTotal;
+    if (report.recordsTotal > 0) {
+        cout << " (" << (report.recordsDone * 100 / report.recordsTotal) << "%)";
+    }
+    cout << ", " << static_cast<long long>(report.recordsPerSecond()) << " records/s";
+    if (report.finished) {
+        cout << (report.recordsDone < report.recordsTotal ? ", stopped after " : ", done in ")
+             << formatMoney(report.elapsedSeconds) << "s" << endl;
+    } else {
+        cout << ", ETA " << static_cast<long long>(report.etaSeconds() + 0.5) << "s (Ctrl+C to cancel)   " << flush;
+    }
+}
+
+// Prompts for a fixed-width file (and its optional "<file>.layout" field layout) and imports it
+void importFixedWidthFile(PayrollSystem& payrollSystem) {
+    cout << "Enter fixed-width file path: ";
+    string path = readInputLine();
+    
+    FixedWidthLayout layout;
+    string layoutPath = path + ".layout";
+    if (filesystem::exists(layoutPath) && !loadFixedWidthLayout(layoutPath, layout)) {
+        cout << "Invalid layout file " << layoutPath << endl;
+        return;
+    }
+    runCancellable([&]() {
+        payrollSystem.importFixedWidth(path, layout);
+    });
+}
+
+// Prompts for how many periods of history to use and forecasts next period's pay
+void forecastNextPeriod(PayrollSystem& payrollSystem) {
+    const size_t DEFAULT_PERIODS = 12;
+    size_t periods = DEFAULT_PERIODS;
+    cout << "Periods of history to use [" << DEFAULT_PERIODS << "]: ";
+    string input = readInputLine();
+    int value;
+    if (!input.empty()) {
+        if (!isValidInteger(input, value) || value <= 0) {
+            cout << "Periods must be a positive whole number." << endl;
+            return;
+        }
+        periods = value;
+    }
+    
+    ForecastResult result;
+    bool completed = false;
+    auto start = chrono::steady_clock::now();
+    runCancellable([&]() {
+        completed = payrollSystem.forecastPay(PAY_HISTORY_DIRECTORY, periods, PAY_FORECAST_FILE, result);
+    });
+    if (!completed) {
+        return;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Forecast for the next period from " << result.periods << " period(s) of history, "
+         << result.employees << " employee(s), in " << formatMoney(seconds * 1000) << " ms:" << endl;
+    cout << "  Latest period total: $" << formatMoney(result.lastTotal) << endl;
+    cout << "  Linear trend forecast: $" << formatMoney(result.trendTotal) << endl;
+    cout << "  Exponential smoothing forecast: $" << formatMoney(result.smoothedTotal) << endl;
+    cout << "Per-employee forecasts written to " << PAY_FORECAST_FILE << endl;
+}
+
+// Prompts for the number of trials and the seed, then simulates next quarter's payroll cost
+void simulateQuarterlyCost(PayrollSystem& payrollSystem) {
+    SimulationSettings settings;
+    int value;
+    cout << "Number of trials [" << settings.trials << "]: ";
+    string input = readInputLine();
+    if (!input.empty()) {
+        if (!isValidInteger(input, value) || value <= 0 || static_cast<size_t>(value) > MAX_SIMULATION_TRIALS) {
+            cout << "Trials must be a whole number from 1 to " << MAX_SIMULATION_TRIALS << "." << endl;
+            return;
+        }
+        settings.trials = value;
+    }
+    cout << "Random seed [" << settings.seed << "]: ";
+    input = readInputLine();
+    if (!input.empty()) {
+        if (!isValidInteger(input, value) || value < 0) {
+            cout << "Seed must be a non-negative whole number." << endl;
+            return;
+        }
+        settings.seed = value;
+    }
+    
+    SimulationResult result;
+    bool completed = false;
+    runCancellable([&]() {
+        completed = payrollSystem.simulateCost(settings, result);
+    });
+    if (!completed) {
+        cout << "Simulation cancelled." << endl;
+        return;
+    }
+    cout << "Quarterly cost over " << result.trials << " trial(s) (seed " << settings.seed << "):" << endl;
+    cout << "  At current hours and projects: $" << formatMoney(result.currentCost) << endl;
+    cout << "  Mean: $" << formatMoney(result.mean) << endl;
+    for (const auto& percentile : result.percentiles) {
+        cout << "  P" << percentile.first << ": $" << formatMoney(percentile.second) << endl;
+    }
+}
+
+// Stream buffer that discards everything, so benchmarks can time console output paths silently
+class NullBuffer : public streambuf {
+    protected:
+        int overflow(int c) override {
+            return c;
+        }
+        
+        streamsize xsputn(const char*, streamsize count) override {
+            return count;
+        }
+};
+
+// Timings of one benchmark: nanoseconds per operation for each repetition
+struct BenchmarkSamples {
+    string name;
+    vector<double> nsPerOp;
+};
+
+double sampleMean(const vector<double>& samples) {
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    return samples.empty() ? 0 : sum / samples.size();
+}
+
+// Unbiased sample variance (n - 1 denominator)
+double sampleVariance(const vector<double>& samples) {
+    if (samples.size() < 2) {
+        return 0;
+    }
+    double mean = sampleMean(samples), sum = 0;
+    for (double sample : samples) {
+        sum += (sample - mean) * (sample - mean);
+    }
+    return sum / (samples.size() - 1);
+}
+
+// Approximates the Student t quantile with df degrees of freedom from the matching
+// normal quantile z (Cornish-Fisher expansion; within 1% for df >= 3)
+double studentQuantile(double z, double df) {
+    double z3 = z * z * z, z5 = z3 * z * z;
+    return z + (z3 + z) / (4 * df) + (5 * z5 + 16 * z3 + 3 * z) / (96 * df * df);
+}
+
+// Runs call (covering opsPerCall operations) repeatedly for at least 20 ms; returns nanoseconds per operation
+double timeRepeated(size_t opsPerCall, const function<void()>& call) {
+    const double MIN_SECONDS = 0.02;
+    size_t calls = 0;
+    auto start = chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        call();
+        ++calls;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (elapsed < MIN_SECONDS);
+    return elapsed * 1e9 / (calls * max<size_t>(1, opsPerCall));
+}
+
+// Deterministic sample employee i, cycling through the three employee types
+Employee* makeBenchmarkEmployee(size_t i) {
+    string id = "B" + to_string(i);
+    string name = "Benchmark Employee " + to_string(i);
+    switch (i % 3) {
+        case 0:
+            return new FullTimeEmployee(id, name, 20000 + i % 5000);
+        case 1:
+            return new PartTimeEmployee(id, name, 100 + i % 50, 20 + i % 40);
+        default:
+            return new ContractualEmployee(id, name, 5000 + i % 2000, static_cast<int>(1 + i % 10));
+    }
+}
+
+// Helper function to fill a roster with size sample employees in one transaction
+void fillBenchmarkRoster(PayrollSystem& system, size_t size) {
+    auto transaction = system.beginTransaction();
+    for (size_t i = 0; i < size; ++i) {
+        transaction.stage(makeBenchmarkEmployee(i));
+    }
+    transaction.commit();
+}
+
+// Saves a roster of size employees to a fresh snapshot directory (encrypted under a fixed key if
+// asked) and loads it back; returns nanoseconds per employee for the save or for the load
+double timeSnapshotRoundTrip(size_t size, bool encrypt, bool measureLoad) {
+    filesystem::path dir = filesystem::temp_directory_path() / "payroll_benchmark_snapshot";
+    filesystem::remove_all(dir);
+    const string key(32, 'k');
+    PayrollSystem source, target;
+    if (encrypt) {
+        source.setSnapshotKey(key);
+        target.setSnapshotKey(key);
+    }
+    fillBenchmarkRoster(source, size);
+    NullBuffer discard;
+    streambuf* console = cout.rdbuf(&discard);
+    auto start = chrono::steady_clock::now();
+    source.saveSnapshot(dir.string());
+    double saveSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    start = chrono::steady_clock::now();
+    target.loadSnapshot(dir.string());
+    double loadSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.rdbuf(console);
+    error_code ec;
+    filesystem::remove_all(dir, ec);
+    return (measureLoad ? loadSeconds : saveSeconds) * 1e9 / size;
+}
+
+// Mixed load: reader threads take snapshots of the roster and sweep them while the writer commits
+// batches. Returns nanoseconds per read (snapshot and sweep) or per commit of a batch; readers
+// that see a partly applied batch are reported.
+double timeMixedLoad(size_t size, bool measureReads) {
+    const size_t BATCH = 100, COMMITS = 200;
+    PayrollSystem system;
+    fillBenchmarkRoster(system, size);
+    size_t readers = min<size_t>(3, max(2u, thread::hardware_concurrency()) - 1);
+    atomic<bool> done{false}, consistent{true};
+    atomic<size_t> reads{0};
+    vector<thread> threads;
+    for (size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&]() {
+            volatile double total = 0;
+            do {
+                auto snapshot = system.takeSnapshot();
+                total = total + snapshot->calculateTotalPayroll();
+                if (snapshot->size() % BATCH != size % BATCH) {
+                    consistent = false;
+                }
+                ++reads;
+            } while (!done);
+        });
+    }
+    auto start = chrono::steady_clock::now();
+    for (size_t c = 0; c < COMMITS; ++c) {
+        auto transaction = system.beginTransaction();
+        for (size_t b = 0; b < BATCH; ++b) {
+            transaction.stage(makeBenchmarkEmployee(size + c * BATCH + b));
+        }
+        transaction.commit();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    done = true;
+    for (thread& reader : threads) {
+        reader.join();
+    }
+    if (!consistent) {
+        cout << "Mixed load: a reader saw a partly applied batch." << endl;
+    }
+    return measureReads ? seconds * readers * 1e9 / max<size_t>(1, reads) : seconds * 1e9 / COMMITS;
+}
+
+// Runs every benchmark at one roster size; each returns nanoseconds per operation for one repetition
+vector<pair<string, function<double()>>> benchmarksForSize(size_t size) {
+    string suffix = "/" + to_string(size);
+    vector<pair<string, function<double()>>> benchmarks;
+    
+    // Adding employees one at a time, each published as its own roster version like a console add
+    benchmarks.emplace_back("insert" + suffix, [size]() {
+        PayrollSystem system;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < size; ++i) {
+            auto transaction = system.beginTransaction();
+            transaction.stage(makeBenchmarkEmployee(i));
+            transaction.commit();
+        }
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count() * 1e9 / size;
+    });
+    
+    // ID lookups, half present and half absent
+    benchmarks.emplace_back("lookup" + suffix, [size]() {
+        PayrollSystem system;
+        fillBenchmarkRoster(system, size);
+        vector<string> ids;
+        for (size_t i = 0; i < size; ++i) {
+            ids.push_back(i % 2 == 0 ? "B" + to_string(i) : "X" + to_string(i));
+        }
+        volatile size_t found = 0;
+        return timeRepeated(ids.size(), [&]() {
+            for (const auto& id : ids) {
+                found = found + system.hasEmployee(id);
+            }
+        });
+    });
+    
+    // Pay computation across the whole roster
+    benchmarks.emplace_back("sweep" + suffix, [size]() {
+        PayrollSystem system;
+        fillBenchmarkRoster(system, size);
+        volatile double total = 0;
+        return timeRepeated(size, [&]() {
+            total = total + system.calculateTotalPayroll();
+        });
+    });
+    
+    // The same pay computation over plain arrays of pay fields, and straight from the bit-packed
+    // columns of snapshot-sized columnar chunks; both on one thread
+    benchmarks.emplace_back("sweep-raw" + suffix, [size]() {
+        vector<char> types(size);
+        vector<double> amounts(size), quantities(size);
+        for (size_t i = 0; i < size; ++i) {
+            unique_ptr<Employee> emp(makeBenchmarkEmployee(i));
+            types[i] = 'F';
+            amounts[i] = emp->calculateSalary();
+            quantities[i] = 1;
+            if (auto partTime = dynamic_cast<const PartTimeEmployee*>(emp.get())) {
+                types[i] = 'P';
+                amounts[i] = partTime->getHourlyWage();
+                quantities[i] = partTime->getHoursWorked();
+            } else if (auto contractual = dynamic_cast<const ContractualEmployee*>(emp.get())) {
+                types[i] = 'C';
+                amounts[i] = contractual->getPaymentPerProject();
+                quantities[i] = contractual->getProjectsCompleted();
+            }
+        }
+        volatile double total = 0;
+        return timeRepeated(size, [&]() {
+            double sum = 0;
+            for (size_t i = 0; i < size; ++i) {
+                sum += types[i] == 'F' ? amounts[i] : amounts[i] * quantities[i];
+            }
+            total = total + sum;
+        });
+    });
+    benchmarks.emplace_back("sweep-columnar" + suffix, [size]() {
+        const size_t CHUNK = 1024;
+        vector<string> chunks;
+        for (size_t begin = 0; begin < size; begin += CHUNK) {
+            vector<unique_ptr<Employee>> owned;
+            vector<const Employee*> emps;
+            for (size_t i = begin; i < min(size, begin + CHUNK); ++i) {
+                owned.emplace_back(makeBenchmarkEmployee(i));
+                emps.push_back(owned.back().get());
+            }
+            chunks.emplace_back();
+            encodeColumnarChunk(emps.data(), emps.size(), chunks.back());
+        }
+        volatile double total = 0;
+        return timeRepeated(size, [&]() {
+            double sum = 0;
+            for (const string& chunk : chunks) {
+                sumColumnarChunkPay(chunk, sum);
+            }
+            total = total + sum;
+        });
+    });
+    
+    // Rendering the full report from scratch after the roster changed
+    benchmarks.emplace_back("report" + suffix, [size]() {
+        PayrollSystem system;
+        fillBenchmarkRoster(system, size);
+        NullBuffer discard;
+        streambuf* console = cout.rdbuf(&discard);
+        auto start = chrono::steady_clock::now();
+        system.displayPayrollReport();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout.rdbuf(console);
+        return seconds * 1e9 / size;
+    });
+    
+    // Saving and loading a snapshot, in plain form and encrypted (when the build supports it)
+    for (bool encrypt : {false, true}) {
+        if (encrypt && !snapshotEncryptionAvailable()) {
+            continue;
+        }
+        string mode = encrypt ? "-encrypted" : "-plain";
+        benchmarks.emplace_back("snapshot-save" + mode + suffix, [size, encrypt]() {
+            return timeSnapshotRoundTrip(size, encrypt, false);
+        });
+        benchmarks.emplace_back("snapshot-load" + mode + suffix, [size, encrypt]() {
+            return timeSnapshotRoundTrip(size, encrypt, true);
+        });
+    }
+    
+    // Snapshot reads and batch commits running at the same time
+    benchmarks.emplace_back("mixed-read" + suffix, [size]() {
+        return timeMixedLoad(size, true);
+    });
+    benchmarks.emplace_back("mixed-commit" + suffix, [size]() {
+        return timeMixedLoad(size, false);
+    });
+    
+    // The same adds and lookups through the C interface, as an embedding service would make them
+    benchmarks.emplace_back("capi-add" + suffix, [size]() {
+        vector<string> ids, names;
+        for (size_t i = 0; i < size; ++i) {
+            ids.push_back("B" + to_string(i));
+            names.push_back("Benchmark Employee " + to_string(i));
+        }
+        payroll_system* system = payroll_create();
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < size; ++i) {
+            payroll_employee employee{static_cast<int>(i % 3), ids[i].c_str(), names[i].c_str(), 1000.0 + i % 500, 1.0 + i % 10};
+            payroll_add(system, &employee);
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        payroll_destroy(system);
+        return seconds * 1e9 / size;
+    });
+    benchmarks.emplace_back("capi-lookup" + suffix, [size]() {
+        payroll_system* system = payroll_create();
+        fillBenchmarkRoster(system->roster, size);
+        vector<string> ids;
+        for (size_t i = 0; i < size; ++i) {
+            ids.push_back("B" + to_string(i));
+        }
+        volatile double pay = 0;
+        double nsPerOp = timeRepeated(ids.size(), [&]() {
+            payroll_lookup_result result;
+            for (const auto& id : ids) {
+                if (payroll_lookup(system, id.c_str(), &result) == PAYROLL_OK) {
+                    pay = pay + result.pay;
+                }
+            }
+        });
+        payroll_destroy(system);
+        return nsPerOp;
+    });
+    
+    // Input validation over typical and adversarial inputs (huge, overflowing and malformed values)
+    benchmarks.emplace_back("validation" + suffix, [size]() {
+        vector<string> inputs = {"25000", "1234.56", "EMP12345", "-0", "1e400", "nan", "inf", "1.2.3", "0x1p3",
+                                 "   ", string(MAX_INPUT_LINE, '9'), string(MAX_INPUT_LINE - 1, 'A') + "!",
+                                 "9" + string(400, '0') + ".5"};
+        vector<string> cases;
+        for (size_t i = 0; i < size; ++i) {
+            cases.push_back(inputs[i % inputs.size()]);
+        }
+        volatile size_t valid = 0;
+        return timeRepeated(cases.size(), [&]() {
+            for (const auto& input : cases) {
+                double decimal;
+                int integer;
+                valid = valid + isValidDecimal(input, decimal) + isValidInteger(input, integer) + isValidID(input);
+            }
+        });
+    });
+    return benchmarks;
+}
+
+// Validation and line reading over adversarial inputs of 1 KB, 64 KB and 1 MB (megabyte-long IDs,
+// pathological digit strings, overlong lines); the operation is one byte, so the cost per byte
+// should stay flat as inputs grow
+vector<pair<string, function<double()>>> inputLengthBenchmarks() {
+    vector<pair<string, function<double()>>> benchmarks;
+    for (size_t length : {size_t(1) << 10, size_t(64) << 10, size_t(1) << 20}) {
+        string suffix = "/" + (length < (size_t(1) << 20) ? to_string(length >> 10) + "KB" : to_string(length >> 20) + "MB");
+        
+        benchmarks.emplace_back("validate-byte" + suffix, [length]() {
+            vector<string> inputs = {string(length - 1, 'A') + "!", string(length - 2, '9') + ".5",
+                                     string(length, '1'), "1." + string(length - 2, '0')};
+            size_t bytes = 0;
+            for (const auto& input : inputs) {
+                bytes += input.size();
+            }
+            volatile size_t valid = 0;
+            return timeRepeated(bytes, [&]() {
+                for (const auto& input : inputs) {
+                    double decimal;
+                    int integer;
+                    valid = valid + isValidDecimal(input, decimal) + isValidInteger(input, integer) + isValidID(input);
+                }
+            });
+        });
+        
+        // Console reads of one overlong line, which is discarded without being buffered
+        benchmarks.emplace_back("readline-byte" + suffix, [length]() {
+            string text = string(length, 'A') + "\n";
+            NullBuffer discard;
+            streambuf* console = cout.rdbuf(&discard);
+            istringstream input;
+            streambuf* keyboard = cin.rdbuf(input.rdbuf());
+            volatile size_t read = 0;
+            double nsPerByte = timeRepeated(text.size(), [&]() {
+                input.str(text);
+                input.clear();
+                read = read + readConsoleLine().size();
+            });
+            cin.rdbuf(keyboard);
+            cout.rdbuf(console);
+            return nsPerByte;
+        });
+    }
+    return benchmarks;
+}
+
+// One operation done the subprocess way: start the console program, have it display the report
+// and exit, and read back all of its output. Runs in a fresh temporary directory so the child starts
+// with an empty audit log and leaves the working directory alone; returns nanoseconds per call.
+double timeSubprocessCall(const string& executable) {
+    filesystem::path workDir = filesystem::temp_directory_path() / "payroll_benchmark";
+    filesystem::remove_all(workDir);
+    filesystem::create_directories(workDir);
+    filesystem::path inputPath = workDir / "payroll_benchmark_input.txt";
+    ofstream(inputPath) << MENU_DISPLAY_REPORT << "\n" << MENU_EXIT << "\n";
+    string command = "\"" + executable + "\" < \"" + inputPath.string() + "\"";
+    
+    filesystem::path previousDir = filesystem::current_path();
+    filesystem::current_path(workDir);
+    volatile size_t outputBytes = 0;
+    double nsPerOp = timeRepeated(1, [&]() {
+        FILE* child = popen(command.c_str(), "r");
+        if (child == nullptr) {
+            return;
         }
+        char buffer[4096];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), child)) > 0) {
+            outputBytes = outputBytes + read;
+        }
+        pclose(child);
+    });
+    filesystem::current_path(previousDir);
+    error_code ec;
+    filesystem::remove_all(workDir, ec);
+    return nsPerOp;
+}
+
+// Helper function to read a baseline file: one benchmark per line, its name then its samples
+bool loadBenchmarkBaseline(const string& path, map<string, vector<double>>& baseline) {
+    ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream fields(line);
+        string name;
+        double sample;
+        fields >> name;
+        while (fields >> sample) {
+            baseline[name].push_back(sample);
+        }
+    }
+    return true;
+}
+
+// Helper function to write results as a baseline file
+bool saveBenchmarkBaseline(const string& path, const vector<BenchmarkSamples>& results) {
+    ofstream out(path, ios::trunc);
+    out << "# Payroll benchmark baseline: name followed by nanoseconds per operation for each repetition\n";
+    out.precision(numeric_limits<double>::max_digits10);
+    for (const auto& result : results) {
+        out << result.name;
+        for (double sample : result.nsPerOp) {
+            out << " " << sample;
+        }
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+// Benchmark mode: payroll --benchmark [--sizes 1000,100000] [--repetitions 10]
+// [--save-baseline FILE] [--compare FILE]. Compares against the baseline with Welch's t-test and
+// exits with status 1 if any benchmark regressed, 2 on a usage or file error.
+int runBenchmarks(int argc, char* argv[]) {
+    const double Z_95_ONE_SIDED = 1.6449, Z_95_TWO_SIDED = 1.96;
+    const double MIN_REGRESSION = 0.05; // Slowdowns under 5% are not flagged even when significant
+    // At least 4 samples on each side keep every t quantile at df >= 3, where studentQuantile is
+    // accurate (Welch's df is never below the smaller sample size minus one)
+    const int MIN_REPETITIONS = 4;
+    
+    vector<size_t> sizes = {1000, 100000};
+    int repetitions = 10;
+    string savePath, comparePath;
+    for (int i = 2; i < argc; ++i) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            cout << "Missing value for " << option << endl;
+            return 2;
+        }
+        string value = argv[++i];
+        if (option == "--sizes") {
+            sizes.clear();
+            istringstream list(value);
+            string item;
+            int size;
+            while (getline(list, item, ',')) {
+                if (!isValidInteger(item, size) || size <= 0) {
+                    cout << "Invalid size: " << item << endl;
+                    return 2;
+                }
+                sizes.push_back(size);
+            }
+        } else if (option == "--repetitions") {
+            if (!isValidInteger(value, repetitions) || repetitions < MIN_REPETITIONS) {
+                cout << "Repetitions must be an integer of at least " << MIN_REPETITIONS << "." << endl;
+                return 2;
+            }
+        } else if (option == "--save-baseline") {
+            savePath = value;
+        } else if (option == "--compare") {
+            comparePath = value;
+        } else {
+            cout << "Unknown option: " << option << endl;
+            return 2;
+        }
+    }
+    map<string, vector<double>> baseline;
+    if (!comparePath.empty() && !loadBenchmarkBaseline(comparePath, baseline)) {
+        cout << "Unable to read baseline " << comparePath << endl;
+        return 2;
+    }
+    
+    // One discarded warm-up repetition, then the measured ones
+    vector<pair<string, function<double()>>> benchmarks;
+    for (size_t size : sizes) {
+        for (auto& benchmark : benchmarksForSize(size)) {
+            benchmarks.push_back(move(benchmark));
+        }
+    }
+    for (auto& benchmark : inputLengthBenchmarks()) {
+        benchmarks.push_back(move(benchmark));
+    }
+    vector<BenchmarkSamples> results;
+    for (auto& benchmark : benchmarks) {
+        BenchmarkSamples result{benchmark.first, {}};
+        benchmark.second();
+        for (int r = 0; r < repetitions; ++r) {
+            result.nsPerOp.push_back(benchmark.second());
+        }
+        results.push_back(result);
+    }
+    
+    // Per-call cost of driving a separate console process, for comparison with the capi benchmarks
+    string executable = argv[0];
+    if (executable.find_first_of("/\\") != string::npos) {
+        executable = filesystem::absolute(executable).string();
+    }
+    BenchmarkSamples subprocess{"subprocess-call", {}};
+    timeSubprocessCall(executable);
+    for (int r = 0; r < repetitions; ++r) {
+        subprocess.nsPerOp.push_back(timeSubprocessCall(executable));
+    }
+    results.push_back(subprocess);
+    
+    bool regressed = false;
+    cout << left << setw(32) << "benchmark" << right << setw(14) << "ns/op" << setw(14) << "95% CI"
+         << setw(14) << "baseline" << "  change [95% CI]" << endl;
+    cout << fixed << setprecision(1);
+    for (const auto& result : results) {
+        size_t n = result.nsPerOp.size();
+        double mean = sampleMean(result.nsPerOp), variance = sampleVariance(result.nsPerOp);
+        double halfWidth = studentQuantile(Z_95_TWO_SIDED, n - 1) * sqrt(variance / n);
+        ostringstream interval;
+        interval << fixed << setprecision(1) << "+-" << halfWidth;
+        cout << left << setw(32) << result.name << right << setw(14) << mean << setw(14) << interval.str();
         
-        // Function to add a part-time employee
-        void addPartTimeEmployee() {
-            string id = getEmployeeId();
-            string name = getEmployeeName();
-            double hourlyWage = getValidDecimalInput("Enter Hourly Wage: $");
-            double hoursWorked = getValidDecimalInput("Enter Number of Hours Worked: ");
-            
-            employees.push_back(new PartTimeEmployee(id, name, hourlyWage, hoursWorked));
-            cout << "Part-time employee added successfully!" << endl;
+        auto base = baseline.find(result.name);
+        if (base == baseline.end()) {
+            cout << setw(14) << "-" << endl;
+            continue;
+        }
+        if (base->second.size() < static_cast<size_t>(MIN_REPETITIONS)) {
+            cout << setw(14) << "-" << "  (baseline has fewer than " << MIN_REPETITIONS << " samples)" << endl;
+            continue;
         }
         
-        // Function to add a contractual employee
-        void addContractualEmployee() {
-            string id = getEmployeeId();
-            string name = getEmployeeName();
-            double paymentPerProject = getValidDecimalInput("Enter Payment Per Project: $");
-            int projectsCompleted = getValidNumericInput("Enter Number of Projects Completed: ");
+        // Welch's t-test on the difference of means, with Welch-Satterthwaite degrees of freedom
+        size_t baseN = base->second.size();
+        double baseMean = sampleMean(base->second), baseVariance = sampleVariance(base->second);
+        double a = variance / n, b = baseVariance / baseN;
+        double standardError = sqrt(a + b);
+        double df = standardError > 0 ? (a + b) * (a + b) / (a * a / (n - 1) + b * b / (baseN - 1)) : 1e9;
+        double difference = mean - baseMean;
+        double t = standardError > 0 ? difference / standardError : (difference > 0 ? HUGE_VAL : 0);
+        double margin = studentQuantile(Z_95_TWO_SIDED, df) * standardError;
+        bool significant = t > studentQuantile(Z_95_ONE_SIDED, df);
+        bool isRegression = significant && difference > MIN_REGRESSION * baseMean;
+        regressed = regressed || isRegression;
+        
+        cout << setw(14) << baseMean << "  " << showpos << (difference / baseMean * 100) << "% ["
+             << ((difference - margin) / baseMean * 100) << "%, " << ((difference + margin) / baseMean * 100) << "%]"
+             << noshowpos;
+        if (isRegression) {
+            cout << "  REGRESSION";
+        } else if (t < -studentQuantile(Z_95_ONE_SIDED, df)) {
+            cout << "  faster";
+        }
+        cout << endl;
+    }
+    cout.unsetf(ios::floatfield);
+    
+    if (!savePath.empty()) {
+        if (!saveBenchmarkBaseline(savePath, results)) {
+            cout << "Unable to write baseline " << savePath << endl;
+            return 2;
+        }
+        cout << "Baseline saved to " << savePath << endl;
+    }
+    if (regressed) {
+        cout << "Performance regression detected." << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Helper function for self-checks: true if a columnar chunk of these employees decodes to the same
+// records and sums to the same pay
+bool columnarRoundTrips(const vector<Employee*>& emps) {
+    string chunk;
+    vector<Employee*> decoded;
+    double expected = 0, total = 0;
+    for (const Employee* emp : emps) {
+        expected += emp->calculateSalary();
+    }
+    bool same = encodeColumnarChunk(emps.data(), emps.size(), chunk) && decodeColumnarChunk(chunk, decoded) &&
+                decoded.size() == emps.size() && sumColumnarChunkPay(chunk, total) &&
+                fabs(total - expected) <= 1e-9 * max(1.0, fabs(expected));
+    for (size_t i = 0; same && i < emps.size(); ++i) {
+        ostringstream original, restored;
+        emps[i]->writeRecord(original);
+        decoded[i]->writeRecord(restored);
+        same = original.str() == restored.str();
+    }
+    for (Employee* emp : decoded) {
+        delete emp;
+    }
+    return same;
+}
+
+// Columnar chunks whose columns are packed in lanes (with a partial group of lanes at the end)
+// and in 64-bit words (values spanning more than 32 bits)
+bool checkColumnarPackedColumns() {
+    vector<Employee*> lanes, wide;
+    for (size_t i = 0; i < 1023; ++i) {
+        lanes.push_back(makeBenchmarkEmployee(i));
+    }
+    for (size_t i = 0; i < 7; ++i) {
+        wide.push_back(new FullTimeEmployee("W" + to_string(i), "Wide", 0.01 + i * 9.0e9));
+    }
+    bool ok = columnarRoundTrips(lanes) && columnarRoundTrips(wide);
+    for (Employee* emp : lanes) {
+        delete emp;
+    }
+    for (Employee* emp : wide) {
+        delete emp;
+    }
+    return ok;
+}
+
+// Columnar chunks with constant pay columns (bit width 0), including a single employee
+bool checkColumnarConstantColumns() {
+    vector<Employee*> one = {new PartTimeEmployee("P1", "Pat", 12.5, 40)};
+    vector<Employee*> equal = {new FullTimeEmployee("F1", "Fay", 30000), new FullTimeEmployee("F2", "Finn", 30000),
+                               new ContractualEmployee("C1", "Cy", 30000, 0)};
+    bool ok = columnarRoundTrips(one) && columnarRoundTrips(equal);
+    for (Employee* emp : one) {
+        delete emp;
+    }
+    for (Employee* emp : equal) {
+        delete emp;
+    }
+    return ok;
+}
+
+// Roster snapshots keep showing their own version while later commits append (past a block
+// boundary) and replace the roster
+bool checkRosterSnapshots() {
+    PayrollSystem system;
+    auto stageRange = [](PayrollSystem::Transaction& transaction, size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            transaction.stage(new FullTimeEmployee("S" + to_string(i), "Snapshot Check", 1000));
+        }
+    };
+    {
+        auto transaction = system.beginTransaction();
+        stageRange(transaction, 0, 1500);
+        transaction.commit();
+    }
+    auto before = system.takeSnapshot();
+    {
+        auto transaction = system.beginTransaction();
+        stageRange(transaction, 1500, 2500);
+        transaction.commit();
+    }
+    auto appended = system.takeSnapshot();
+    {
+        PayrollSystem::Transaction transaction(system, true);
+        stageRange(transaction, 5000, 5010);
+        transaction.commit();
+    }
+    auto replaced = system.takeSnapshot();
+    return before->size() == 1500 && (*before)[1499].getId() == "S1499" && before->calculateTotalPayroll() == 1500 * 1000.0 &&
+           appended->size() == 2500 && (*appended)[2499].getId() == "S2499" && replaced->size() == 10 &&
+           (*replaced)[0].getId() == "S5000" && before->getVersion() < appended->getVersion() &&
+           appended->getVersion() < replaced->getVersion();
+}
+
+// HMAC-SHA-256 against RFC 4231 test case 2 (chunk names of encrypted snapshots depend on it)
+bool checkHmacSha256() {
+    return bytesToHex(hmacSha256("Jefe", "what do ya want for nothing?")) ==
+           "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843";
+}
+
+// SHA-256 against the FIPS 180-2 example messages (the audit log's hashes and chain depend on it)
+bool checkSha256() {
+    return bytesToHex(sha256("")) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" &&
+           bytesToHex(sha256("abc")) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" &&
+           bytesToHex(sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")) ==
+               "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" &&
+           bytesToHex(sha256(string(1000000, 'a'))) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0";
+}
+
+// Runs the built-in consistency checks (--self-check); returns 0 if all pass
+int runSelfChecks() {
+    const vector<pair<const char*, bool (*)()>> checks = {
+        {"columnar chunk with constant columns", checkColumnarConstantColumns},
+        {"columnar chunk with lane-packed and wide columns", checkColumnarPackedColumns},
+        {"roster snapshots across commits", checkRosterSnapshots},
+        {"SHA-256 (FIPS 180-2)", checkSha256},
+        {"HMAC-SHA-256 (RFC 4231)", checkHmacSha256},
+    };
+    int failures = 0;
+    for (const auto& check : checks) {
+        bool ok = check.second();
+        cout << (ok ? "ok      " : "FAILED  ") << check.first << endl;
+        failures += ok ? 0 : 1;
+    }
+    cout << (failures == 0 ? "All checks passed." : "Some checks failed.") << endl;
+    return failures == 0 ? 0 : 1;
+}
+
+// Hierarchical timer wheel over whole ticks: LEVELS wheels of SLOTS slots, where a slot of level k
+// covers SLOTS^k ticks. A timer goes straight into the slot of the level matching its distance, and
+// when a lower wheel wraps the next slot of the wheel above is cascaded down, so insertion and expiry
+// are O(1) per timer (a timer cascades at most LEVELS - 1 times). Timers further out than the top
+// wheel spans wait in its last slot and are re-placed each time it cascades.
+class TimerWheel {
+    private:
+        static const unsigned SLOT_BITS = 6;
+        static const uint64_t SLOTS = 1 << SLOT_BITS;
+        static const unsigned LEVELS = 4;
+        
+        struct Timer {
+            uint64_t due;
+            size_t id;
+        };
+        
+        vector<Timer> slots[LEVELS][SLOTS];
+        uint64_t currentTick = 0;
+        size_t pending = 0;
+        
+        // Helper function to put a timer in the slot matching its distance from the current tick
+        void place(const Timer& timer) {
+            uint64_t distance = timer.due - currentTick;
+            for (unsigned level = 0; level < LEVELS; ++level) {
+                if (distance < (SLOTS << (SLOT_BITS * level))) {
+                    slots[level][(timer.due >> (SLOT_BITS * level)) & (SLOTS - 1)].push_back(timer);
+                    return;
+                }
+            }
+            uint64_t farthest = currentTick + (SLOTS << (SLOT_BITS * (LEVELS - 1))) - 1;
+            slots[LEVELS - 1][(farthest >> (SLOT_BITS * (LEVELS - 1))) & (SLOTS - 1)].push_back(timer);
+        }
+        
+        // Helper function to move the timers of one slot down to the levels below
+        void cascade(unsigned level) {
+            vector<Timer> moving;
+            moving.swap(slots[level][(currentTick >> (SLOT_BITS * level)) & (SLOTS - 1)]);
+            for (const Timer& timer : moving) {
+                place(timer);
+            }
+        }
+        
+    public:
+        uint64_t now() const {
+            return currentTick;
+        }
+        
+        size_t size() const {
+            return pending;
+        }
+        
+        // Function to add a timer; one that is already due fires on the next tick
+        void schedule(uint64_t due, size_t id) {
+            place(Timer{max(due, currentTick + 1), id});
+            ++pending;
+        }
+        
+        // Function to advance one tick, appending the timers that expire on it to expired
+        void tick(vector<size_t>& expired) {
+            ++currentTick;
+            for (unsigned level = 1; level < LEVELS && (currentTick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0; ++level) {
+                cascade(level);
+            }
+            vector<Timer>& slot = slots[0][currentTick & (SLOTS - 1)];
+            for (const Timer& timer : slot) {
+                expired.push_back(timer.id);
+            }
+            pending -= slot.size();
+            slot.clear();
+        }
+};
+
+// Fixed set of worker threads with a bounded queue: submit() blocks while the queue is full, so a
+// burst of due jobs is absorbed at the pool's pace instead of starting a thread per job
+class BoundedWorkerPool {
+    private:
+        vector<thread> workers;
+        deque<pair<function<void()>, chrono::steady_clock::time_point>> queue;
+        size_t capacity;
+        mutex lock;
+        condition_variable notEmpty, notFull, idle;
+        size_t running = 0;
+        bool stopping = false;
+        
+        size_t peakQueued = 0;
+        double totalWaitSeconds = 0, maxWaitSeconds = 0;
+        size_t started = 0;
+        
+        void work() {
+            unique_lock<mutex> guard(lock);
+            while (true) {
+                notEmpty.wait(guard, [this] { return stopping || !queue.empty(); });
+                if (queue.empty()) {
+                    return;
+                }
+                function<void()> job = move(queue.front().first);
+                double wait = chrono::duration<double>(chrono::steady_clock::now() - queue.front().second).count();
+                queue.pop_front();
+                ++running;
+                ++started;
+                totalWaitSeconds += wait;
+                maxWaitSeconds = max(maxWaitSeconds, wait);
+                notFull.notify_one();
+                
+                guard.unlock();
+                job();
+                guard.lock();
+                --running;
+                if (running == 0 && queue.empty()) {
+                    idle.notify_all();
+                }
+            }
+        }
+        
+    public:
+        BoundedWorkerPool(size_t threads, size_t queueCapacity) : capacity(max<size_t>(1, queueCapacity)) {
+            for (size_t i = 0; i < max<size_t>(1, threads); ++i) {
+                workers.emplace_back(&BoundedWorkerPool::work, this);
+            }
+        }
+        
+        ~BoundedWorkerPool() {
+            {
+                lock_guard<mutex> guard(lock);
+                stopping = true;
+            }
+            notEmpty.notify_all();
+            for (thread& worker : workers) {
+                worker.join();
+            }
+        }
+        
+        void submit(function<void()> job) {
+            unique_lock<mutex> guard(lock);
+            notFull.wait(guard, [this] { return queue.size() < capacity; });
+            queue.emplace_back(move(job), chrono::steady_clock::now());
+            peakQueued = max(peakQueued, queue.size());
+            notEmpty.notify_one();
+        }
+        
+        // Function to wait until every submitted job has finished
+        void drain() {
+            unique_lock<mutex> guard(lock);
+            idle.wait(guard, [this] { return running == 0 && queue.empty(); });
+        }
+        
+        size_t getThreadCount() const {
+            return workers.size();
+        }
+        
+        void printSummary(ostream& out) {
+            lock_guard<mutex> guard(lock);
+            out << fixed << setprecision(1) << "Worker pool: " << workers.size() << " thread(s), queue limit " << capacity
+                << ", peak queue " << peakQueued << ", queue wait mean "
+                << (started > 0 ? totalWaitSeconds / started * 1000 : 0) << " ms, max " << maxWaitSeconds * 1000 << " ms" << endl;
+            out.unsetf(ios::floatfield);
+        }
+};
+
+// Pay calendar of a scheduled job
+enum class PayCalendar { Weekly, BiWeekly, Monthly };
+
+// Recurring job on one tenant's roster. A tenant is a directory holding its own snapshots
+// (SNAPSHOT_DIRECTORY layout), payroll checkpoint, pay history and exported report. The tenant's
+// roster is its latest snapshot, saved by whoever maintains the roster (the console's Save
+// Snapshot run in that directory, or a program using the library); scheduled jobs only read it.
+struct ScheduledJob {
+    string tenant;
+    string action;          // "payroll" or "export"
+    PayCalendar calendar;
+    int anchorDay;          // Day of the month monthly jobs fall on (clamped to short months)
+    time_t firstDue;        // First occurrence as written in the schedule
+    time_t nextDue;
+};
+
+// File in each tenant directory recording the last completed occurrence of each of its jobs
+const string SCHEDULE_STATE_FILE = "payroll_schedule.state";
+
+// Scheduler of recurring payroll runs and report exports across tenants. Due times live in a
+// timer wheel with one-second ticks; jobs that come due are dispatched to a bounded worker pool,
+// and jobs on the same tenant run one at a time, in the order they came due.
+class PayrollScheduler {
+    private:
+        // One due occurrence of a job, with its due time formatted for the log
+        struct DueRun {
+            ScheduledJob job;
+            string label;
+        };
+        
+        // Runs of one tenant waiting behind the one in flight. Only one run per tenant is handed to
+        // the pool at a time, so workers never sit waiting on another run of the same tenant.
+        struct TenantQueue {
+            deque<DueRun> waiting;
+            bool inFlight = false;
+        };
+        
+        vector<ScheduledJob> jobs;
+        map<string, TenantQueue> tenants;
+        vector<DueRun> ready;   // Next runs of tenants whose previous run finished, for the dispatcher
+        mutex queueLock;
+        TimerWheel wheel;
+        time_t epoch;
+        string snapshotKey;
+        shared_ptr<MemoryBudget> memoryBudget = make_shared<MemoryBudget>(); // Shared by every job's roster
+        
+        ostream& log;
+        mutex logLock;
+        atomic<size_t> succeeded{0}, failed{0};
+        bool dryRun = false;    // Simulating: log what would run, touching no tenant files
+        map<string, size_t> dispatchedByAction;
+        
+        // Helper function to order jobs due on the same tick: pay first, then export
+        static int actionOrder(const string& action) {
+            return action == "payroll" ? 0 : 1;
+        }
+        
+        // Helper function to compute the next due time of a job after the given one
+        static time_t nextOccurrence(const ScheduledJob& job, time_t after) {
+            tm next = localCalendarTime(after);
+            next.tm_isdst = -1;
+            if (job.calendar == PayCalendar::Monthly) {
+                // Day 0 of the month after next is the last day of next month
+                tm monthEnd = next;
+                monthEnd.tm_mon += 2;
+                monthEnd.tm_mday = 0;
+                mktime(&monthEnd);
+                next.tm_mon += 1;
+                next.tm_mday = min(job.anchorDay, monthEnd.tm_mday);
+            } else {
+                next.tm_mday += job.calendar == PayCalendar::Weekly ? 7 : 14;
+            }
+            return mktime(&next);
+        }
+        
+        // Helper function to identify a job in its tenant's state file
+        static string stateKey(const ScheduledJob& job) {
+            const char* calendars[] = {"weekly", "biweekly", "monthly"};
+            return job.action + " " + calendars[static_cast<int>(job.calendar)] + " " + to_string(job.firstDue);
+        }
+        
+        // Helper function to read a tenant's state file: job key -> last completed occurrence
+        static map<string, time_t> readState(const string& tenant) {
+            map<string, time_t> state;
+            ifstream in(filesystem::path(tenant) / SCHEDULE_STATE_FILE);
+            string action, calendar;
+            long long first, last;
+            while (in >> action >> calendar >> first >> last) {
+                state[action + " " + calendar + " " + to_string(first)] = static_cast<time_t>(last);
+            }
+            return state;
+        }
+        
+        // Helper function to record a completed occurrence. Only one run per tenant is in flight,
+        // so the tenant's state file is never updated concurrently.
+        static bool recordCompletion(const ScheduledJob& job) {
+            map<string, time_t> state = readState(job.tenant);
+            state[stateKey(job)] = job.nextDue;
+            string data;
+            for (const auto& entry : state) {
+                data += entry.first + " " + to_string(static_cast<long long>(entry.second)) + "\n";
+            }
+            return writeFileAtomically(filesystem::path(job.tenant) / SCHEDULE_STATE_FILE, data);
+        }
+        
+        // Helper function to convert a due time to a wheel tick
+        uint64_t tickOf(time_t due) const {
+            return due > epoch ? static_cast<uint64_t>(due - epoch) : 0;
+        }
+        
+        void logLine(const string& line) {
+            lock_guard<mutex> guard(logLock);
+            log << line << endl;
+        }
+        
+        // Helper function to run one job against its tenant's roster
+        bool runJob(const ScheduledJob& job) {
+            filesystem::path dir(job.tenant);
+            PayrollSystem roster;
+            roster.shareMemoryBudget(memoryBudget);
+            if (!snapshotKey.empty()) {
+                roster.setSnapshotKey(snapshotKey);
+            }
+            if (!roster.loadSnapshot((dir / SNAPSHOT_DIRECTORY).string())) {
+                return false;
+            }
+            if (job.action == "payroll") {
+                return roster.runPayroll((dir / PAYROLL_CHECKPOINT_FILE).string()) &&
+                       roster.recordPayPeriod((dir / PAY_HISTORY_DIRECTORY).string(), formatPayDate(job.nextDue));
+            }
+            return writeFileAtomically(dir / PAYROLL_REPORT_FILE, [&roster](ostream& out) { return roster.writePayrollReport(out); });
+        }
+        
+        // Helper function to run a due occurrence on the pool. When it finishes, the tenant's next
+        // waiting run is passed back to the dispatcher: submitting it from the worker could block
+        // every worker on a full queue.
+        void submitRun(DueRun run, BoundedWorkerPool& pool) {
+            pool.submit([this, run] {
+                bool ok = false;
+                if (dryRun) {
+                    ok = true;
+                } else {
+                    try {
+                        ok = runJob(run.job) && recordCompletion(run.job);
+                    } catch (const exception&) {
+                        ok = false;
+                    }
+                }
+                (ok ? succeeded : failed)++;
+                logLine(run.label + "  " + (dryRun ? "would run " : "") + run.job.action + " " + run.job.tenant +
+                        (ok ? "" : "  FAILED"));
+                
+                lock_guard<mutex> guard(queueLock);
+                TenantQueue& queue = tenants[run.job.tenant];
+                if (queue.waiting.empty()) {
+                    queue.inFlight = false;
+                } else {
+                    ready.push_back(move(queue.waiting.front()));
+                    queue.waiting.pop_front();
+                }
+            });
+        }
+        
+        // Helper function to submit the runs released by finished ones; returns how many there were
+        size_t submitReady(BoundedWorkerPool& pool) {
+            vector<DueRun> released;
+            {
+                lock_guard<mutex> guard(queueLock);
+                released.swap(ready);
+            }
+            for (DueRun& run : released) {
+                submitRun(move(run), pool);
+            }
+            return released.size();
+        }
+        
+        // Helper function to queue a due job behind its tenant's run in flight (or hand it to the
+        // pool if there is none) and put its next occurrence on the wheel
+        void dispatch(size_t id, BoundedWorkerPool& pool) {
+            DueRun run{jobs[id], string()};
+            ++dispatchedByAction[run.job.action];
+            do {
+                jobs[id].nextDue = nextOccurrence(jobs[id], jobs[id].nextDue);
+            } while (jobs[id].nextDue <= epoch + static_cast<time_t>(wheel.now()));
+            wheel.schedule(tickOf(jobs[id].nextDue), id);
             
-            employees.push_back(new ContractualEmployee(id, name, paymentPerProject, projectsCompleted));
-            cout << "Contractual employee added successfully!" << endl;
+            char due[32];
+            tm dueParts = localCalendarTime(run.job.nextDue);
+            strftime(due, sizeof(due), "%Y-%m-%d %H:%M", &dueParts);
+            run.label = due;
+            {
+                lock_guard<mutex> guard(queueLock);
+                TenantQueue& queue = tenants[run.job.tenant];
+                if (queue.inFlight) {
+                    queue.waiting.push_back(move(run));
+                    return;
+                }
+                queue.inFlight = true;
+            }
+            submitRun(move(run), pool);
         }
         
-        // Function to display payroll report
-        void displayPayrollReport() const {
-            if (employees.empty()) {
-                cout << "No employees to display." << endl;
-                return;
+    public:
+        PayrollScheduler(ostream& out) : epoch(time(nullptr)), log(out) {}
+        
+        void setSnapshotKey(const string& key) {
+            snapshotKey = key;
+        }
+        
+        // Sets the memory budget shared by the rosters of jobs running side by side (0 means
+        // unlimited). A job loading into a full budget waits for other jobs to finish.
+        void setMemoryBudget(size_t bytes) {
+            memoryBudget->setLimit(bytes);
+        }
+        
+        // Function to read a schedule: one job per line as "tenant-directory calendar action
+        // YYYY-MM-DD HH:MM" (calendar weekly, biweekly or monthly; action payroll or export), with
+        // # starting a comment
+        bool loadSchedule(const string& path) {
+            ifstream in(path);
+            if (!in) {
+                log << "Unable to read schedule " << path << endl;
+                return false;
+            }
+            string line;
+            size_t lineNumber = 0;
+            while (getline(in, line)) {
+                ++lineNumber;
+                line = line.substr(0, line.find('#'));
+                istringstream fields(line);
+                ScheduledJob job;
+                string calendar;
+                if (!(fields >> job.tenant)) {
+                    continue;
+                }
+                tm first = {};
+                fields >> calendar >> job.action >> get_time(&first, "%Y-%m-%d %H:%M");
+                first.tm_isdst = -1;
+                if (fields.fail() || (calendar != "weekly" && calendar != "biweekly" && calendar != "monthly") ||
+                    (job.action != "payroll" && job.action != "export")) {
+                    log << "Invalid schedule entry on line " << lineNumber << " of " << path << endl;
+                    return false;
+                }
+                job.calendar = calendar == "weekly" ? PayCalendar::Weekly
+                             : calendar == "biweekly" ? PayCalendar::BiWeekly : PayCalendar::Monthly;
+                job.anchorDay = first.tm_mday;
+                job.firstDue = mktime(&first);
+                job.nextDue = job.firstDue;
+                tenants[job.tenant];
+                jobs.push_back(job);
+            }
+            return true;
+        }
+        
+        // Function to run the schedule until stopTime, ticking once per wall-clock second. Simulating
+        // is a dry run: the clock advances as fast as the pool accepts runs (stopTime is then in
+        // simulated time) and each due run is only logged, so no tenant file or state is written.
+        void run(time_t stopTime, bool simulate, size_t threads, const CancellationToken& cancellation) {
+            BoundedWorkerPool pool(threads, threads * 4);
+            dryRun = simulate;
+            // Resume each job after its last completed occurrence. Of the occurrences missed since
+            // then (while the scheduler was down), only the latest runs, on the first tick.
+            map<string, map<string, time_t>> states;
+            for (size_t id = 0; id < jobs.size(); ++id) {
+                ScheduledJob& job = jobs[id];
+                if (!states.count(job.tenant)) {
+                    states[job.tenant] = readState(job.tenant);
+                }
+                const map<string, time_t>& state = states[job.tenant];
+                auto last = state.find(stateKey(job));
+                while ((last != state.end() && job.nextDue <= last->second) || nextOccurrence(job, job.nextDue) <= epoch) {
+                    job.nextDue = nextOccurrence(job, job.nextDue);
+                }
+                wheel.schedule(tickOf(job.nextDue), id);
             }
+            log << "Scheduling " << jobs.size() << " job(s) on " << tenants.size() << " tenant(s) with "
+                << pool.getThreadCount() << " worker(s)" << (simulate ? " (dry run on a simulated clock)" : "") << endl;
             
-            cout << "------ Employee Payroll Report ------" << endl;
+            vector<size_t> expired;
+            uint64_t stopTick = tickOf(stopTime);
+            while (wheel.now() < stopTick && !cancellation.isCancelled()) {
+                submitReady(pool);
+                if (!simulate) {
+                    uint64_t wallTick = tickOf(time(nullptr));
+                    if (wheel.now() >= wallTick) {
+                        this_thread::sleep_for(chrono::milliseconds(200));
+                        continue;
+                    }
+                }
+                expired.clear();
+                wheel.tick(expired);
+                stable_sort(expired.begin(), expired.end(), [this](size_t a, size_t b) {
+                    return actionOrder(jobs[a].action) < actionOrder(jobs[b].action);
+                });
+                for (size_t id : expired) {
+                    dispatch(id, pool);
+                }
+            }
+            // Finish the runs already due, including those still queued behind their tenant
+            do {
+                pool.drain();
+            } while (submitReady(pool) > 0);
             
-            for (const auto& emp : employees) {
-                emp->displayPayrollReport();
-                cout << endl;
+            log << (dryRun ? "Would dispatch " : "Dispatched ") << (succeeded + failed) << " job(s)";
+            for (const auto& entry : dispatchedByAction) {
+                log << ", " << entry.second << " " << entry.first;
+            }
+            log << "; " << failed << " failed" << endl;
+            pool.printSummary(log);
+            if (memoryBudget->getLimit() != 0) {
+                memoryBudget->printSummary(log);
             }
         }
 };
 
-int main() {
+// Runs the scheduler: --schedule FILE [--workers N] [--simulate DAYS]. Jobs write their console
+// output nowhere; the scheduler logs one line per finished job. --simulate is a dry run over the
+// next DAYS days that only logs what would run. PAYROLL_MEMORY_BUDGET_MB caps the rosters of all
+// running jobs together.
+int runScheduler(int argc, char* argv[]) {
+    string schedulePath;
+    int workers = static_cast<int>(max(1u, thread::hardware_concurrency()));
+    int simulateDays = 0;
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        if (option == "--schedule" && i + 1 < argc) {
+            schedulePath = argv[++i];
+        } else if (option == "--workers" && i + 1 < argc && isValidInteger(argv[i + 1], workers) && workers > 0) {
+            ++i;
+        } else if (option == "--simulate" && i + 1 < argc && isValidInteger(argv[i + 1], simulateDays) && simulateDays > 0) {
+            ++i;
+        } else {
+            cout << "Usage: " << argv[0] << " --schedule FILE [--workers N] [--simulate DAYS]" << endl;
+            return 2;
+        }
+    }
+    
+    NullBuffer discard;
+    ostream log(cout.rdbuf());
+    PayrollScheduler scheduler(log);
+    if (!scheduler.loadSchedule(schedulePath)) {
+        return 2;
+    }
+    // An unusable key stops the scheduler rather than failing every job on an encrypted snapshot
+    string snapshotKey, keyError;
+    if (!readSnapshotKeySetting(snapshotKey, keyError)) {
+        log << keyError << "; the scheduler will not start." << endl;
+        return 2;
+    }
+    scheduler.setSnapshotKey(snapshotKey);
+    scheduler.setMemoryBudget(readMemoryBudgetSetting());
+    adaptiveExecutor.calibrate();
+    
+    // Ctrl+C stops the scheduler after the jobs already dispatched
+    LongOperationScope scope;
+    signal(SIGINT, handleInterrupt);
+    cout.rdbuf(&discard);
+    time_t stopTime = simulateDays > 0 ? time(nullptr) + static_cast<time_t>(simulateDays) * 24 * 60 * 60
+                                       : numeric_limits<time_t>::max();
+    scheduler.run(stopTime, simulateDays > 0, static_cast<size_t>(workers), consoleCancellation);
+    cout.rdbuf(log.rdbuf());
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--benchmark") {
+        adaptiveExecutor.calibrate();
+        return runBenchmarks(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--self-check") {
+        return runSelfChecks();
+    }
+    if (argc > 1 && string(argv[1]) == "--schedule") {
+        return runScheduler(argc, argv);
+    }
+    
+    // Session options: --record FILE saves the input lines; --replay FILE feeds them back at full
+    // speed (--realtime keeps the recorded pauses, --quiet hides console output) and prints latencies
+    string recordPath, replayPath;
+    bool realTime = false, quiet = false;
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        if ((option == "--record" || option == "--replay") && i + 1 < argc) {
+            (option == "--record" ? recordPath : replayPath) = argv[++i];
+        } else if (option == "--realtime") {
+            realTime = true;
+        } else if (option == "--quiet") {
+            quiet = true;
+        } else {
+            cout << "Usage: " << argv[0] << " [--record FILE | --replay FILE [--realtime] [--quiet] | --benchmark ... | --schedule ... | --self-check]" << endl;
+            return 2;
+        }
+    }
+    if (!recordPath.empty() && !consoleSession.startRecording(recordPath, MENU_VERSION)) {
+        cout << "Unable to record session to " << recordPath << endl;
+        return 2;
+    }
+    string replayError;
+    if (!replayPath.empty() && !consoleSession.startReplay(replayPath, MENU_VERSION, realTime, replayError)) {
+        cout << "Unable to replay session " << replayPath << ": " << replayError << endl;
+        return 2;
+    }
+    NullBuffer discard;
+    streambuf* console = cout.rdbuf();
+    if (quiet && consoleSession.isReplaying()) {
+        cout.rdbuf(&discard);
+    }
+    
     PayrollSystem payrollSystem;
+    if (!payrollSystem.openAuditLog(AUDIT_LOG_FILE)) {
+        cout << "Warning: unable to open audit log " << AUDIT_LOG_FILE << " (unwritable, or shorter than its head file "
+             << AUDIT_LOG_FILE << ".head); changes will not be audited." << endl;
+    }
+    
+    // Optional memory budget for employee records, e.g. PAYROLL_MEMORY_BUDGET_MB=512
+    payrollSystem.setMemoryBudget(readMemoryBudgetSetting());
+    
+    // Optional encryption of snapshots at rest: PAYROLL_SNAPSHOT_KEY holds a 64-hex-digit AES-256 key
+    string snapshotKey, keyError;
+    if (!readSnapshotKeySetting(snapshotKey, keyError)) {
+        cout << "Warning: " << keyError << "; snapshots will not be encrypted." << endl;
+    } else if (!snapshotKey.empty()) {
+        payrollSystem.setSnapshotKey(snapshotKey);
+    }
+    
+    // Optional slow-operation threshold for the flight recorder, e.g. PAYROLL_SLOW_OP_MS=50
+    if (const char* threshold = getenv("PAYROLL_SLOW_OP_MS")) {
+        int milliseconds;
+        if (isValidInteger(threshold, milliseconds) && milliseconds >= 0) {
+            flightRecorder.setSlowThreshold(milliseconds / 1000.0);
+        }
+    }
+    
+    // Measure thread start-up and per-record costs so sweeps pick serial or parallel execution
+    adaptiveExecutor.calibrate();
+    
+    // Long operations report progress on the console and stop between chunks on Ctrl+C
+    payrollSystem.setProgressCallback(showProgress);
+    payrollSystem.setCancellationToken(&consoleCancellation);
+    signal(SIGINT, handleInterrupt);
+    
+    // Dump recent operations on a crash (and on request via SIGUSR1 where available)
+    signal(SIGSEGV, dumpFlightRecorder);
+    signal(SIGABRT, dumpFlightRecorder);
+    signal(SIGFPE, dumpFlightRecorder);
+    signal(SIGILL, dumpFlightRecorder);
+#ifdef SIGUSR1
+    signal(SIGUSR1, dumpFlightRecorder);
+#endif
+    
+    // Names of the menu commands, for latency statistics
+    const vector<string> COMMAND_NAMES = {"invalid choice", "add full-time employee", "add part-time employee",
+                                          "add contractual employee", "display report", "save snapshot",
+                                          "load snapshot", "run payroll", "find duplicates", "verify audit log",
+                                          "import fixed-width", "import NDJSON", "simulate cost", "forecast pay", "browse report", "exit"};
     string choice;
     
-    do {
-        // Display main menu
-        cout << "\n=============================\n";
-        cout << "    PAYROLL SYSTEM MENU    \n";
-        cout << "=============================\n";
-        cout << "[1] Full-time Employee\n";
-        cout << "[2] Part-time Employee\n";
-        cout << "[3] Contractual Employee\n";
-        cout << "[4] Display Payroll Report\n";
-        cout << "[5] Exit\n";
-        cout << "=============================\n";
-        cout << "Enter your choice: ";
-        getline(cin, choice);
-            
-        int option;
-        if (isValidMenuNumber(choice, option, 1, 5)) {
-            switch (option) {
-                case 1:
-                    payrollSystem.addFullTimeEmployee();
-                    break;
-                case 2:
-                    payrollSystem.addPartTimeEmployee();
-                    break;
-                case 3:
-                    payrollSystem.addContractualEmployee();
-                    break;
-                case 4:
-                    payrollSystem.displayPayrollReport();
-                    break;
-                case 5:
-                    cout << "Exiting program. Goodbye!" << endl;
-                    break;
+    try {
+        do {
+            payrollSystem.reportBackgroundIndexing();
+            
+            // Display main menu
+            cout << "\n=============================\n";
+            cout << "    PAYROLL SYSTEM MENU    \n";
+            cout << "=============================\n";
+            cout << "[1] Full-time Employee\n";
+            cout << "[2] Part-time Employee\n";
+            cout << "[3] Contractual Employee\n";
+            cout << "[4] Display Payroll Report\n";
+            cout << "[5] Save Snapshot\n";
+            cout << "[6] Load Snapshot\n";
+            cout << "[7] Run Payroll\n";
+            cout << "[8] Find Possible Duplicates\n";
+            cout << "[9] Verify Audit Log\n";
+            cout << "[10] Import Fixed-Width File\n";
+            cout << "[11] Import NDJSON File\n";
+            cout << "[12] Simulate Quarterly Cost\n";
+            cout << "[13] Forecast Pay\n";
+            cout << "[14] Browse Payroll Report\n";
+            cout << "[" << MENU_EXIT << "] Exit\n";
+            cout << "=============================\n";
+            cout << "Enter your choice: ";
+            choice = readInputLine();
+            
+            // Latency covers the command's own work, not the time spent waiting at its prompts
+            auto commandStart = chrono::steady_clock::now();
+            double waitBefore = consoleSession.getInputWaitSeconds();
+            int option = 0;
+            if (isValidMenuNumber(choice, option, 1, MENU_EXIT)) {
+                switch (option) {
+                    case 1:
+                        payrollSystem.addFullTimeEmployee();
+                        break;
+                    case 2:
+                        payrollSystem.addPartTimeEmployee();
+                        break;
+                    case 3:
+                        payrollSystem.addContractualEmployee();
+                        break;
+                    case MENU_DISPLAY_REPORT:
+                        runCancellable([&]() { payrollSystem.displayPayrollReport(); });
+                        break;
+                    case 5:
+                        payrollSystem.saveSnapshot(SNAPSHOT_DIRECTORY);
+                        break;
+                    case 6:
+                        runCancellable([&]() { payrollSystem.loadSnapshot(SNAPSHOT_DIRECTORY); });
+                        break;
+                    case 7:
+                        runCancellable([&]() {
+                            if (payrollSystem.runPayroll(PAYROLL_CHECKPOINT_FILE)) {
+                                payrollSystem.recordPayPeriod(PAY_HISTORY_DIRECTORY, formatPayDate(time(nullptr)));
+                            }
+                        });
+                        break;
+                    case 8:
+                        runCancellable([&]() { payrollSystem.findProbableDuplicates(); });
+                        break;
+                    case 9:
+                        payrollSystem.flushAuditLog();
+                        AuditLog::verify(AUDIT_LOG_FILE);
+                        break;
+                    case 10:
+                        importFixedWidthFile(payrollSystem);
+                        break;
+                    case 11: {
+                        cout << "Enter NDJSON file path: ";
+                        string path = readInputLine();
+                        runCancellable([&]() { payrollSystem.importNdjson(path); });
+                        break;
+                    }
+                    case 12:
+                        simulateQuarterlyCost(payrollSystem);
+                        break;
+                    case 13:
+                        forecastNextPeriod(payrollSystem);
+                        break;
+                    case 14:
+                        payrollSystem.browsePayrollReport();
+                        break;
+                    case MENU_EXIT:
+                        cout << "Exiting program. Goodbye!" << endl;
+                        break;
+                }
+            } else {
+                cout << "Invalid choice. Please enter a number between 1 and " << MENU_EXIT << "." << endl;
+                option = 0;
             }
-        } else {
-            cout << "Invalid choice. Please enter a number between 1 and 5." << endl;
-        }
-    } while (choice != "5");
+            double commandSeconds = chrono::duration<double>(chrono::steady_clock::now() - commandStart).count();
+            consoleSession.recordCommand(COMMAND_NAMES[option], commandSeconds - (consoleSession.getInputWaitSeconds() - waitBefore));
+        } while (choice != to_string(MENU_EXIT));
+    } catch (const InputClosedError&) {
+        // Input ended (e.g. a piped session finished) without choosing Exit
+        cout << "\nInput closed. Goodbye!" << endl;
+    }
+    
+    cout.rdbuf(console);
+    if (consoleSession.isReplaying()) {
+        consoleSession.printSummary(cout);
+    }
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,104 @@
+/*
+ * C interface to the payroll engine, for running it in-process instead of driving the console
+ * program. Build the library by compiling Sahagun-abstraction-and-encapsulation.cpp with
+ * -DPAYROLL_LIBRARY (which leaves out main), e.g.
+ *
+ *     g++ -std=c++17 -O2 -pthread -shared -fPIC -DPAYROLL_LIBRARY Sahagun-abstraction-and-encapsulation.cpp -o libpayroll.so
+ *
+ * The ABI is stable: functions and enum values are only ever added, and structs are never
+ * changed. Strings are UTF-8 and NUL-terminated. A payroll_system must not be used from two
+ * threads at once.
+ */
+#ifndef PAYROLL_H
+#define PAYROLL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Version of this interface; payroll_api_version() returns the version the library implements */
+#define PAYROLL_API_VERSION 1
+
+/* Opaque handle to one roster */
+typedef struct payroll_system payroll_system;
+
+typedef enum payroll_status {
+    PAYROLL_OK = 0,
+    PAYROLL_INVALID_ARGUMENT = 1,   /* Null pointer, or a field the console prompts would reject */
+    PAYROLL_DUPLICATE_ID = 2,
+    PAYROLL_NOT_FOUND = 3,
+    PAYROLL_BUFFER_TOO_SMALL = 4,   /* The required size is returned through the length argument */
+    PAYROLL_MEMORY_BUDGET = 5,      /* The roster's memory budget would be exceeded */
+    PAYROLL_INTERNAL_ERROR = 6,
+    PAYROLL_IO_ERROR = 7            /* A file could not be opened or written */
+} payroll_status;
+
+typedef enum payroll_employee_type {
+    PAYROLL_FULL_TIME = 0,
+    PAYROLL_PART_TIME = 1,
+    PAYROLL_CONTRACTUAL = 2
+} payroll_employee_type;
+
+/* An employee to add, validated like console entry */
+typedef struct payroll_employee {
+    int type;               /* A payroll_employee_type */
+    const char* id;         /* Letters and digits only */
+    const char* name;       /* Non-empty, no line breaks */
+    double amount;          /* Monthly salary, hourly wage or payment per project: above 0, at most 2 decimals */
+    double quantity;        /* Hours worked (above 0, at most 2 decimals) or projects completed (a whole
+                               number, 0 or more); ignored for full-time */
+} payroll_employee;
+
+/* An employee found by ID; name points into the roster and is valid until the roster changes */
+typedef struct payroll_lookup_result {
+    int type;
+    const char* name;
+    double pay;
+} payroll_lookup_result;
+
+int payroll_api_version(void);
+
+/* Describes a status code; the string is static */
+const char* payroll_status_message(payroll_status status);
+
+/* Creates an empty roster (returns NULL if out of memory) and destroys one (NULL is ignored) */
+payroll_system* payroll_create(void);
+void payroll_destroy(payroll_system* system);
+
+/* Opens (creating if needed) the tamper-evident audit log at path, with its head file at
+   path + ".head"; from then on every added employee is recorded in it. Fails with
+   PAYROLL_IO_ERROR if the log is shorter than its head file records. Without this call nothing
+   is audited. */
+payroll_status payroll_open_audit(payroll_system* system, const char* path);
+
+/* Limits the memory held by employee records (0 means unlimited) */
+payroll_status payroll_set_memory_budget(payroll_system* system, size_t bytes);
+
+/* Adds one employee */
+payroll_status payroll_add(payroll_system* system, const payroll_employee* employee);
+
+/* Adds count employees atomically: on failure none are added and, if failed_index is not NULL,
+   it receives the index of the first rejected employee */
+payroll_status payroll_add_batch(payroll_system* system, const payroll_employee* employees, size_t count,
+                                 size_t* failed_index);
+
+/* Looks up an employee by ID */
+payroll_status payroll_lookup(const payroll_system* system, const char* id, payroll_lookup_result* result);
+
+size_t payroll_count(const payroll_system* system);
+
+/* Total pay across the roster; receives 0 for an empty roster */
+payroll_status payroll_total(const payroll_system* system, double* total);
+
+/* Copies the payroll report text, NUL-terminated, into buffer. *length receives the report size
+   in bytes (excluding the NUL); if capacity is not larger than that, PAYROLL_BUFFER_TOO_SMALL is
+   returned and nothing is written, so callers can size the buffer with a first call. */
+payroll_status payroll_report(const payroll_system* system, char* buffer, size_t capacity, size_t* length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PAYROLL_H */